@@ -0,0 +1,108 @@
+#
+# This code is part of MaNGOS. Contributor & Copyright details are in AUTHORS/THANKS.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+
+import re
+import struct
+import sys
+import time
+
+# file header and record layout, see src/game/Server/PacketCapture.h
+CAPTURE_MAGIC = 0x544B504D
+CAPTURE_VERSION = 1
+RECORD_HEADER = struct.Struct("<IQIIHBB")
+
+# pcap with a user link type and a small pseudo header per packet
+PCAP_LINKTYPE_USER0 = 147
+PCAP_PSEUDO_HEADER = struct.Struct("<BBHII")
+
+
+def usage():
+    print("Usage: %s text|pcap <capture file> <output file> [Opcodes.h]" % sys.argv[0])
+    sys.exit(1)
+
+
+def loadOpcodeNames(path):
+    names = {}
+    pattern = re.compile(r"^\s*(\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)\s*,")
+    for line in open(path):
+        match = pattern.match(line)
+        if match:
+            names[int(match.group(2), 0)] = match.group(1)
+    return names
+
+
+def readRecords(path):
+    data = open(path, "rb").read()
+    if len(data) < 8:
+        raise ValueError("%s is not a packet capture" % path)
+
+    magic, version = struct.unpack_from("<II", data, 0)
+    if magic != CAPTURE_MAGIC or version != CAPTURE_VERSION:
+        raise ValueError("%s is not a packet capture of version %u" % (path, CAPTURE_VERSION))
+
+    offset = 8
+    while offset + RECORD_HEADER.size <= len(data):
+        size, stamp, socket, account, opcode, direction, reserved = RECORD_HEADER.unpack_from(data, offset)
+        end = offset + 4 + size
+        if end > len(data):
+            print("Truncated record at offset %u, stopped" % offset)
+            break
+
+        yield stamp, socket, account, opcode, direction, data[offset + RECORD_HEADER.size:end]
+        offset = end
+
+
+def writeText(records, output, names):
+    out = open(output, "w")
+    for stamp, socket, account, opcode, direction, payload in records:
+        # same layout as the WorldLogFile dump
+        out.write("%s.%03u\n" % (time.strftime("%Y-%m-%d %H:%M:%S", time.localtime(stamp // 1000)), stamp % 1000))
+        out.write("%s:\n" % ("CLIENT" if direction == 0 else "SERVER"))
+        out.write("SOCKET: %u\nACCOUNT: %u\nLENGTH: %u\n" % (socket, account, len(payload)))
+        out.write("OPCODE: %s (0x%.4X)\nDATA:\n" % (names.get(opcode, "UNKNOWN"), opcode))
+        for line in range(0, len(payload), 16):
+            out.write(" ".join("%.2X" % b for b in bytearray(payload[line:line + 16])) + " \n")
+        out.write("\n\n")
+    out.close()
+
+
+def writePcap(records, output):
+    out = open(output, "wb")
+    out.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, 65535 + PCAP_PSEUDO_HEADER.size, PCAP_LINKTYPE_USER0))
+    for stamp, socket, account, opcode, direction, payload in records:
+        length = PCAP_PSEUDO_HEADER.size + len(payload)
+        out.write(struct.pack("<IIII", stamp // 1000, (stamp % 1000) * 1000, length, length))
+        out.write(PCAP_PSEUDO_HEADER.pack(direction, 0, opcode, socket, account))
+        out.write(payload)
+    out.close()
+
+
+def main():
+    if len(sys.argv) < 4 or sys.argv[1] not in ("text", "pcap"):
+        usage()
+
+    names = loadOpcodeNames(sys.argv[4]) if len(sys.argv) > 4 else {}
+    records = readRecords(sys.argv[2])
+    if sys.argv[1] == "text":
+        writeText(records, sys.argv[3], names)
+    else:
+        writePcap(records, sys.argv[3])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,335 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file SpellBench.cpp
+ * @brief Scripted spell cast benchmark without a running server
+ *
+ * Boots the world from the databases, DBC and map files named by a mangosd
+ * configuration file, like mangosd does, but opens no network listener. On
+ * one continent it then spawns pairs of caster and target creatures and
+ * runs a fixed number of rounds: every caster casts the spell on its target,
+ * then the world is updated by one map tick, which runs the delayed spell
+ * hits, periodic aura ticks, melee and procs. Creatures that die are
+ * replaced.
+ *
+ * The SpellProfiler is enabled for the rounds only. The report holds casts
+ * per second of wall time, Spell allocations and the self time percentiles
+ * of the prepare, cast, aura tick and proc stages. Running the same scenario
+ * before and after a change to Spell.cpp, SpellEffects.cpp or SpellAuras.cpp
+ * shows a regression without players.
+ *
+ * Built with -DBUILD_BENCHMARKS=1, run from the build directory:
+ *     spell_bench -s <spell> -e <caster entry> [-t <target entry>]
+ *                 [-c <config>] [-n <rounds>] [-p <pairs>]
+ *                 [-m <map> -x <x> -y <y> -z <z>] [-d <tick ms>]
+ *
+ * Casts are triggered, so cast times, cooldowns, power and reagents do not
+ * throttle them. Caster and target entries should be hostile to each other
+ * for harmful spells. Instanced maps need a player and are refused.
+ */
+
+#include <ace/Get_Opt.h>
+
+#include "Common.h"
+#include "Database/DatabaseEnv.h"
+#include "Config/Config.h"
+#include "Log.h"
+#include "SystemConfig.h"
+#include "World.h"
+#include "MapManager.h"
+#include "ObjectMgr.h"
+#include "DBCStores.h"
+#include "GridMap.h"
+#include "TemporarySummon.h"
+#include "ScriptMgr.h"
+#include "SpellProfiler.h"
+
+#include <chrono>
+#include <vector>
+
+DatabaseType WorldDatabase;                                 ///< Accessor to the world database
+DatabaseType CharacterDatabase;                             ///< Accessor to the character database
+DatabaseType LoginDatabase;                                 ///< Accessor to the realm/login database
+
+uint32 realmID = 0;                                         ///< Id of the realm
+
+/**
+ * @brief One caster and the target it casts on
+ */
+struct CastPair
+{
+    Creature* caster;
+    Creature* target;
+    float x, y, z;                                          ///< spawn point of the caster
+};
+
+/// Print out the usage string for this program on the console.
+static void usage(const char* prog)
+{
+    sLog.outString("Usage: \n %s -s <spell> -e <caster entry> [<options>]\n"
+        "    -s <spell>                 spell id cast by every caster\n\r"
+        "    -e <entry>                 creature entry of the casters\n\r"
+        "    -t <entry>                 creature entry of the targets, default caster entry\n\r"
+        "    -c <config_file>           use config_file as configuration file\n\r"
+        "    -n <rounds>                casts per caster, default 1000\n\r"
+        "    -p <pairs>                 caster and target pairs, default 10\n\r"
+        "    -m <map> -x -y -z          continent and position, default Northshire Abbey\n\r"
+        "    -d <ms>                    map tick after every round, default MapUpdateInterval\n\r"
+    , prog);
+}
+
+/**
+ * @brief Connect one database
+ * @param database Database to connect
+ * @param name Prefix of the configuration settings
+ * @return True if connected
+ */
+static bool StartDatabase(DatabaseType& database, char const* name)
+{
+    std::string dbstring = sConfig.GetStringDefault((std::string(name) + "DatabaseInfo").c_str(), "");
+    int nConnections = sConfig.GetIntDefault((std::string(name) + "DatabaseConnections").c_str(), 1);
+    if (dbstring.empty() || !database.Initialize(dbstring.c_str(), nConnections))
+    {
+        sLog.outError("Can not connect to %s database %s", name, dbstring.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Spawn a creature that is updated without players around
+ * @param map Continent to spawn on
+ * @param cinfo Creature template
+ * @param x, y, z Spawn point, z is moved to the ground
+ * @return Spawned creature or NULL
+ */
+static Creature* SpawnCreature(Map* map, CreatureInfo const* cinfo, float x, float y, float z)
+{
+    float groundZ = map->GetHeight(x, y, z);
+    if (groundZ > INVALID_HEIGHT)
+    {
+        z = groundZ;
+    }
+
+    TemporarySummon* creature = new TemporarySummon();
+    CreatureCreatePos pos(map, x, y, z, 0.0f);
+    if (!creature->Create(map->GenerateLocalLowGuid(cinfo->GetHighGuid()), pos, cinfo))
+    {
+        delete creature;
+        return NULL;
+    }
+
+    creature->SetRespawnCoord(pos);
+    creature->SetActiveObjectState(true);
+    creature->Summon(TEMPSUMMON_MANUAL_DESPAWN, 0);
+    return creature;
+}
+
+/**
+ * @brief Replace a dead creature of a pair by a fresh one
+ * @param creature Creature to check, replaced in place
+ * @param map Continent of the pair
+ * @param x, y, z Spawn point
+ * @return False if no creature could be spawned
+ */
+static bool ReplaceIfDead(Creature*& creature, Map* map, float x, float y, float z)
+{
+    if (creature->IsAlive())
+    {
+        return true;
+    }
+
+    CreatureInfo const* cinfo = creature->GetCreatureInfo();
+    ((TemporarySummon*)creature)->UnSummon();
+    creature = SpawnCreature(map, cinfo, x, y, z);
+    return creature != NULL;
+}
+
+/**
+ * @brief Print the spell profile like the .debug spellprofile command
+ * @param casts Casts issued by the benchmark
+ * @param elapsed Wall time of the rounds in ms
+ */
+static void PrintReport(uint64 casts, uint64 elapsed)
+{
+    sLog.outString(UI64FMTD " casts in " UI64FMTD " ms, %.1f casts/s", casts, elapsed, elapsed ? casts * 1000.0f / elapsed : 0.0f);
+    sLog.outString("Spell objects: " UI64FMTD " allocated (" UI64FMTD " from pool), peak " SI64FMTD,
+                   sSpellProfiler.GetAllocatedSpells(), sSpellProfiler.GetRecycledSpells(), sSpellProfiler.GetPeakSpells());
+
+    for (uint32 i = 0; i < MAX_SPELL_PROFILE_STAGES; ++i)
+    {
+        SpellProfileStage stage = SpellProfileStage(i);
+        sLog.outString("%-9s: " UI64FMTD " calls, avg " UI64FMTD " us, p50 " UI64FMTD " us, p95 " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us",
+                       SpellProfiler::GetStageName(stage), sSpellProfiler.GetCount(stage),
+                       sSpellProfiler.GetAverage(stage), sSpellProfiler.GetPercentile(stage, 50.0f),
+                       sSpellProfiler.GetPercentile(stage, 95.0f), sSpellProfiler.GetPercentile(stage, 99.0f),
+                       sSpellProfiler.GetMax(stage));
+    }
+}
+
+/// Run the benchmark
+int main(int argc, char** argv)
+{
+    char const* cfg_file = MANGOSD_CONFIG_LOCATION;
+    uint32 spellId = 0;
+    uint32 casterEntry = 0;
+    uint32 targetEntry = 0;
+    uint32 rounds = 1000;
+    uint32 pairs = 10;
+    uint32 tick = 0;
+    uint32 mapId = 0;
+    float x = -8949.95f, y = -132.49f, z = 83.53f;          // Northshire Abbey
+
+    ACE_Get_Opt cmd_opts(argc, argv, ":c:s:e:t:n:p:m:x:y:z:d:");
+
+    int option;
+    while ((option = cmd_opts()) != EOF)
+    {
+        char const* arg = cmd_opts.opt_arg();
+        switch (option)
+        {
+            case 'c': cfg_file = arg; break;
+            case 's': spellId = uint32(atoi(arg)); break;
+            case 'e': casterEntry = uint32(atoi(arg)); break;
+            case 't': targetEntry = uint32(atoi(arg)); break;
+            case 'n': rounds = uint32(atoi(arg)); break;
+            case 'p': pairs = uint32(atoi(arg)); break;
+            case 'm': mapId = uint32(atoi(arg)); break;
+            case 'x': x = float(atof(arg)); break;
+            case 'y': y = float(atof(arg)); break;
+            case 'z': z = float(atof(arg)); break;
+            case 'd': tick = uint32(atoi(arg)); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (!spellId || !casterEntry || !rounds || !pairs)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!targetEntry)
+    {
+        targetEntry = casterEntry;
+    }
+
+    if (!sConfig.SetSource(cfg_file) && !sConfig.SetSource(MANGOSD_CONFIG_NAME))
+    {
+        sLog.outError("Could not find configuration file %s.", cfg_file);
+        return 1;
+    }
+
+    realmID = sConfig.GetIntDefault("RealmID", 0);
+    if (!StartDatabase(WorldDatabase, "World") || !StartDatabase(CharacterDatabase, "Character") || !StartDatabase(LoginDatabase, "Login"))
+    {
+        return 1;
+    }
+
+    ///- Load DBC, SQLStorage and scripts as mangosd does
+    sWorld.SetInitialWorldSettings();
+
+    SpellEntry const* spellInfo = sSpellStore.LookupEntry(spellId);
+    CreatureInfo const* casterInfo = ObjectMgr::GetCreatureTemplate(casterEntry);
+    CreatureInfo const* targetInfo = ObjectMgr::GetCreatureTemplate(targetEntry);
+    MapEntry const* mapEntry = sMapStore.LookupEntry(mapId);
+    if (!spellInfo || !casterInfo || !targetInfo || !mapEntry || mapEntry->Instanceable())
+    {
+        sLog.outError("Unknown spell %u, creature entry %u or %u, or map %u is not a continent", spellId, casterEntry, targetEntry, mapId);
+        return 1;
+    }
+
+    if (!tick)
+    {
+        tick = sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE);
+    }
+
+    Map* map = sMapMgr.CreateMap(mapId, NULL);
+
+    ///- Pairs on a grid of 5 yards, the target 2 yards from its caster
+    std::vector<CastPair> castPairs(pairs);
+    for (uint32 i = 0; i < pairs; ++i)
+    {
+        CastPair& pair = castPairs[i];
+        pair.x = x + (i % 10) * 5.0f;
+        pair.y = y + (i / 10) * 5.0f;
+        pair.z = z;
+        pair.caster = SpawnCreature(map, casterInfo, pair.x, pair.y, pair.z);
+        pair.target = SpawnCreature(map, targetInfo, pair.x + 2.0f, pair.y, pair.z);
+        if (!pair.caster || !pair.target)
+        {
+            sLog.outError("Could not spawn creatures at (%f, %f, %f) on map %u", pair.x, pair.y, pair.z, mapId);
+            return 1;
+        }
+    }
+
+    ///- Settle spawning and grid loading before measuring
+    sWorld.Update(tick);
+
+    sSpellProfiler.Reset();
+    sSpellProfiler.SetEnabled(true);
+
+    uint64 casts = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32 round = 0; round < rounds; ++round)
+    {
+        for (std::vector<CastPair>::iterator itr = castPairs.begin(); itr != castPairs.end(); ++itr)
+        {
+            if (!ReplaceIfDead(itr->caster, map, itr->x, itr->y, itr->z) || !ReplaceIfDead(itr->target, map, itr->x + 2.0f, itr->y, itr->z))
+            {
+                sLog.outError("Could not replace a dead creature at (%f, %f, %f)", itr->x, itr->y, itr->z);
+                return 1;
+            }
+
+            itr->caster->CastSpell(itr->target, spellInfo, true);
+            ++casts;
+        }
+
+        sWorld.Update(tick);
+    }
+    uint64 elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    sSpellProfiler.SetEnabled(false);
+    sLog.outString("Spell %u cast by %u creatures of entry %u on entry %u, %u rounds of %u ms", spellId, pairs, casterEntry, targetEntry, rounds, tick);
+    PrintReport(casts, elapsed);
+
+    for (std::vector<CastPair>::iterator itr = castPairs.begin(); itr != castPairs.end(); ++itr)
+    {
+        ((TemporarySummon*)itr->caster)->UnSummon();
+        ((TemporarySummon*)itr->target)->UnSummon();
+    }
+
+    sMapMgr.UnloadAll();
+
+    CharacterDatabase.HaltDelayThread();
+    WorldDatabase.HaltDelayThread();
+    LoginDatabase.HaltDelayThread();
+
+    sScriptMgr.UnloadScriptLibrary();
+    return 0;
+}
@@ -48,6 +48,11 @@
 #include "ObjectMgr.h"
 #include "ObjectGuid.h"
 #include "SpellMgr.h"
+#include "SpellProfiler.h"
+#include "CollisionProfiler.h"
+#include "WorldPacketPool.h"
+#include "WorldSession.h"
+#include "World.h"
 
 /**
  * @brief Handler for HandleDebugSendSpellFailCommand command.
@@ -1670,3 +1675,261 @@ bool ChatHandler::HandleDebugSpellModsCommand(char* args)
 
     return true;
 }
+
+/**
+ * @brief Handler for HandleDebugSpellProfileCommand command.
+ *
+ * Without arguments shows the collected spell system statistics,
+ * otherwise enables/disables recording (on/off) or clears it (reset).
+ *
+ * @param args Command arguments.
+ * @returns True if the command executed successfully, false otherwise.
+ */
+bool ChatHandler::HandleDebugSpellProfileCommand(char* args)
+{
+    if (*args)
+    {
+        if (ExtractLiteralArg(&args, "reset"))
+        {
+            sSpellProfiler.Reset();
+            SendSysMessage("Spell profile data cleared.");
+            return true;
+        }
+
+        bool value;
+        if (!ExtractOnOff(&args, value))
+        {
+            SendSysMessage(LANG_USE_BOL);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        sSpellProfiler.SetEnabled(value);
+        PSendSysMessage("Spell profiling %sabled.", value ? "en" : "dis");
+        return true;
+    }
+
+    PSendSysMessage("Spell profiling is %sabled, times are self time without nested stages.", sSpellProfiler.IsEnabled() ? "en" : "dis");
+    PSendSysMessage("Spell objects: " UI64FMTD " allocated (" UI64FMTD " from pool), " SI64FMTD " alive, peak " SI64FMTD,
+                    sSpellProfiler.GetAllocatedSpells(), sSpellProfiler.GetRecycledSpells(), sSpellProfiler.GetLiveSpells(), sSpellProfiler.GetPeakSpells());
+
+    for (uint32 i = 0; i < MAX_SPELL_PROFILE_STAGES; ++i)
+    {
+        SpellProfileStage stage = SpellProfileStage(i);
+        PSendSysMessage("%-9s: " UI64FMTD " calls (%.1f/s), avg " UI64FMTD " us, p50 " UI64FMTD " us, p95 " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us",
+                        SpellProfiler::GetStageName(stage), sSpellProfiler.GetCount(stage), sSpellProfiler.GetRate(stage),
+                        sSpellProfiler.GetAverage(stage), sSpellProfiler.GetPercentile(stage, 50.0f),
+                        sSpellProfiler.GetPercentile(stage, 95.0f), sSpellProfiler.GetPercentile(stage, 99.0f),
+                        sSpellProfiler.GetMax(stage));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Handler for HandleDebugCollisionProfileCommand command.
+ *
+ * Without arguments shows the collected collision query statistics,
+ * otherwise enables/disables recording (on/off), clears it (reset),
+ * captures static queries into a file (capture $file|off) or replays
+ * such a file and checks the answers (replay $file [$maxQueries]).
+ * Capture and replay touch server files and are console only.
+ *
+ * @param args Command arguments.
+ * @returns True if the command executed successfully, false otherwise.
+ */
+bool ChatHandler::HandleDebugCollisionProfileCommand(char* args)
+{
+    if (*args)
+    {
+        if (ExtractLiteralArg(&args, "reset"))
+        {
+            sCollisionProfiler.Reset();
+            SendSysMessage("Collision profile data cleared.");
+            return true;
+        }
+
+        bool capture = ExtractLiteralArg(&args, "capture") != NULL;
+        bool replay = !capture && ExtractLiteralArg(&args, "replay") != NULL;
+        if ((capture || replay) && m_session)
+        {
+            SendSysMessage("Collision query capture and replay can only be used from the console.");
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        if (capture)
+        {
+            if (ExtractLiteralArg(&args, "off"))
+            {
+                PSendSysMessage("Collision capture stopped, %u queries written.", sCollisionProfiler.StopCapture());
+                return true;
+            }
+
+            char* fileName = ExtractQuotedOrLiteralArg(&args);
+            if (!fileName)
+            {
+                return false;
+            }
+
+            if (!sCollisionProfiler.StartCapture(fileName))
+            {
+                PSendSysMessage("Can not open %s for writing.", fileName);
+                SetSentErrorMessage(true);
+                return false;
+            }
+
+            PSendSysMessage("Capturing collision queries to %s.", fileName);
+            return true;
+        }
+
+        if (replay)
+        {
+            char* fileName = ExtractQuotedOrLiteralArg(&args);
+            if (!fileName)
+            {
+                return false;
+            }
+
+            uint32 maxQueries;
+            if (!ExtractOptUInt32(&args, maxQueries, 0))
+            {
+                return false;
+            }
+
+            if (sCollisionProfiler.IsCapturing())
+            {
+                SendSysMessage("Stop the running collision capture first.");
+                SetSentErrorMessage(true);
+                return false;
+            }
+
+            CollisionProfiler replayStats;
+            CollisionReplayResult result;
+            if (!replayStats.Replay(fileName, maxQueries, result))
+            {
+                PSendSysMessage("Can not read collision capture %s.", fileName);
+                SetSentErrorMessage(true);
+                return false;
+            }
+
+            PSendSysMessage("Replayed %s in %u ms.", fileName, result.elapsed);
+            for (uint32 i = 0; i < MAX_COLLISION_QUERY_TYPES; ++i)
+            {
+                CollisionQueryType type = CollisionQueryType(i);
+                if (!result.queries[type])
+                {
+                    continue;
+                }
+
+                PSendSysMessage("%-9s: %u queries, %u mismatches, avg " UI64FMTD " us, p50 " UI64FMTD " us, p95 " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us",
+                                CollisionProfiler::GetTypeName(type), result.queries[type], result.mismatches[type],
+                                replayStats.GetAverage(type), replayStats.GetPercentile(type, 50.0f),
+                                replayStats.GetPercentile(type, 95.0f), replayStats.GetPercentile(type, 99.0f),
+                                replayStats.GetMax(type));
+            }
+            return true;
+        }
+
+        bool value;
+        if (!ExtractOnOff(&args, value))
+        {
+            SendSysMessage(LANG_USE_BOL);
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        sCollisionProfiler.SetEnabled(value);
+        PSendSysMessage("Collision profiling %sabled.", value ? "en" : "dis");
+        return true;
+    }
+
+    PSendSysMessage("Collision profiling is %sabled, capture is %s.", sCollisionProfiler.IsEnabled() ? "en" : "dis", sCollisionProfiler.IsCapturing() ? "running" : "stopped");
+
+    for (uint32 i = 0; i < MAX_COLLISION_QUERY_TYPES; ++i)
+    {
+        CollisionQueryType type = CollisionQueryType(i);
+        PSendSysMessage("%-9s: " UI64FMTD " queries (%.1f/s), avg " UI64FMTD " us, p50 " UI64FMTD " us, p95 " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us",
+                        CollisionProfiler::GetTypeName(type), sCollisionProfiler.GetCount(type), sCollisionProfiler.GetRate(type),
+                        sCollisionProfiler.GetAverage(type), sCollisionProfiler.GetPercentile(type, 50.0f),
+                        sCollisionProfiler.GetPercentile(type, 95.0f), sCollisionProfiler.GetPercentile(type, 99.0f),
+                        sCollisionProfiler.GetMax(type));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Handler for HandleDebugPacketQueuesCommand command.
+ *
+ * Shows the received packet pool statistics and the sessions with the
+ * most packets waiting, with the longest time a handled packet of each
+ * waited since the last call. Then the sessions with the most bytes
+ * waiting to be sent to their client.
+ *
+ * @param args Optional number of sessions to list, 10 by default.
+ * @returns True if the command executed successfully, false otherwise.
+ */
+bool ChatHandler::HandleDebugPacketQueuesCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+    {
+        return false;
+    }
+
+    uint64 acquired = sWorldPacketPool.GetAcquired();
+    uint64 recycled = sWorldPacketPool.GetRecycled();
+    PSendSysMessage("Received packets: " UI64FMTD ", " UI64FMTD " (%.1f%%) recycled, %u pooled",
+                    acquired, recycled, acquired ? recycled * 100.0f / acquired : 0.0f, sWorldPacketPool.GetDepotSize());
+
+    std::vector<std::pair<uint32, WorldSession*> > sessions;
+    uint64 queued = 0;
+
+    World::SessionMap const& sessionMap = sWorld.GetAllSessions();
+    for (World::SessionMap::const_iterator itr = sessionMap.begin(); itr != sessionMap.end(); ++itr)
+    {
+        uint32 size = itr->second->GetRecvQueueSize();
+        queued += size;
+        sessions.push_back(std::make_pair(size, itr->second));
+    }
+
+    PSendSysMessage("Queued packets: " UI64FMTD " in %u sessions", queued, uint32(sessions.size()));
+
+    count = std::min(count, uint32(sessions.size()));
+    std::partial_sort(sessions.begin(), sessions.begin() + count, sessions.end(), std::greater<std::pair<uint32, WorldSession*> >());
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        WorldSession* session = sessions[i].second;
+        PSendSysMessage("Account %u (%s): %u queued, longest wait %u ms",
+                        session->GetAccountId(), session->GetPlayerName(), sessions[i].first, session->GetRecvMaxAge(true));
+    }
+
+    // the same for the data waiting to be sent to the clients
+    uint64 backlog = 0;
+    uint32 congested = 0;
+
+    for (uint32 i = 0; i < sessions.size(); ++i)
+    {
+        sessions[i].first = sessions[i].second->GetSendBacklog();
+        backlog += sessions[i].first;
+        if (sessions[i].second->IsSendCongested())
+        {
+            ++congested;
+        }
+    }
+
+    PSendSysMessage("Bytes to send: " UI64FMTD ", %u sessions over the send budget", backlog, congested);
+
+    std::partial_sort(sessions.begin(), sessions.begin() + count, sessions.end(), std::greater<std::pair<uint32, WorldSession*> >());
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        WorldSession* session = sessions[i].second;
+        PSendSysMessage("Account %u (%s): %u bytes to send (%u packets queued), " UI64FMTD " sent",
+                        session->GetAccountId(), session->GetPlayerName(), sessions[i].first, session->GetSendQueuedPackets(), session->GetSentBytes());
+    }
+
+    return true;
+}
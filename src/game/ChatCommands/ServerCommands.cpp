@@ -40,6 +40,8 @@
 #include "GitRevision.h"
 #include "SystemConfig.h"
 #include "UpdateTime.h"
+#include "Opcodes.h"
+#include "OpcodeStats.h"
 #include "revision_data.h"
 
 /**
@@ -103,6 +105,100 @@ bool ChatHandler::HandleServerMotdCommand(char* /*args*/)
     return true;
 }
 
+/**
+ * @brief Orders opcode totals by one counter, highest first.
+ */
+struct OpcodeStatsOrder
+{
+    explicit OpcodeStatsOrder(uint64 OpcodeStatsEntry::* counter) : m_counter(counter) {}
+
+    bool operator()(OpcodeStatsEntry const& left, OpcodeStatsEntry const& right) const
+    {
+        return left.*m_counter > right.*m_counter;
+    }
+
+    uint64 OpcodeStatsEntry::* m_counter;
+};
+
+/**
+ * @brief Handler for HandleServerOpcodesCommand command.
+ *
+ * Lists the opcodes with the highest counters since the last reset, ordered
+ * by total handler time or by calls, max, in, out, sent or throttled.
+ * 'reset' clears all counters.
+ *
+ * @param args Optional order and number of opcodes to list, 10 by default.
+ * @returns True if the command executed successfully, false otherwise.
+ */
+bool ChatHandler::HandleServerOpcodesCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sOpcodeStats.Reset();
+        SendSysMessage("Opcode statistics cleared.");
+        return true;
+    }
+
+    uint64 OpcodeStatsEntry::* counter = &OpcodeStatsEntry::time;
+    if (ExtractLiteralArg(&args, "calls"))
+    {
+        counter = &OpcodeStatsEntry::calls;
+    }
+    else if (ExtractLiteralArg(&args, "max"))
+    {
+        counter = &OpcodeStatsEntry::maxTime;
+    }
+    else if (ExtractLiteralArg(&args, "in"))
+    {
+        counter = &OpcodeStatsEntry::bytesIn;
+    }
+    else if (ExtractLiteralArg(&args, "out"))
+    {
+        counter = &OpcodeStatsEntry::bytesOut;
+    }
+    else if (ExtractLiteralArg(&args, "sent"))
+    {
+        counter = &OpcodeStatsEntry::sent;
+    }
+    else if (ExtractLiteralArg(&args, "throttled"))
+    {
+        counter = &OpcodeStatsEntry::throttled;
+    }
+    else
+    {
+        ExtractLiteralArg(&args, "time");
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+    {
+        return false;
+    }
+
+    if (!sOpcodeStats.IsEnabled())
+    {
+        SendSysMessage("Opcode statistics are disabled (OpcodeStats in mangosd.conf).");
+    }
+
+    std::vector<OpcodeStatsEntry> entries;
+    sOpcodeStats.Collect(entries);
+
+    count = std::min(count, uint32(entries.size()));
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(), OpcodeStatsOrder(counter));
+
+    PSendSysMessage("Opcodes of the last %u seconds, %u with traffic:", sOpcodeStats.GetElapsed() / IN_MILLISECONDS, uint32(entries.size()));
+    for (uint32 i = 0; i < count; ++i)
+    {
+        OpcodeStatsEntry const& entry = entries[i];
+        PSendSysMessage("%s (0x%.4X): " UI64FMTD " calls, " UI64FMTD " us total, " UI64FMTD " us avg, " UI64FMTD " us max, "
+                        UI64FMTD " bytes in, " UI64FMTD " sent, " UI64FMTD " bytes out, " UI64FMTD " throttled",
+                        LookupOpcodeName(entry.opcode), entry.opcode, entry.calls, entry.time, entry.calls ? entry.time / entry.calls : 0,
+                        entry.maxTime, entry.bytesIn, entry.sent, entry.bytesOut, entry.throttled);
+    }
+
+    return true;
+}
+
 /**
  * @brief Handler for HandleServerShutDownCancelCommand command.
  *
@@ -0,0 +1,255 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file GridPreloader.cpp
+ * @brief Implementation of the GridPreloader class for reading terrain files ahead.
+ *
+ * This file contains the implementation of the GridPreloader class which reads
+ * the .map, vmap and mmap tile files of a grid on a background thread, so that
+ * the synchronous grid load on the map thread does not wait for the disk.
+ */
+
+#include "GridPreloader.h"
+#include "DelayExecutor.h"
+#include "World.h"
+#include "Log.h"
+#include "VMapFactory.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+/// Size of the buffer the tile files are read through
+#define GRID_PRELOAD_READ_CHUNK 65536
+
+/**
+ * @brief Packs the map id and terrain grid coordinates into a single key.
+ * @param mapId Id of the map.
+ * @param gx Terrain grid X coordinate.
+ * @param gy Terrain grid Y coordinate.
+ * @return The packed key.
+ */
+static uint32 PackGridKey(uint32 mapId, uint32 gx, uint32 gy)
+{
+    return (mapId << 12) | (gx << 6) | gy;
+}
+
+/**
+ * @brief Reads a whole file and discards its content.
+ * @param fileName Path of the file.
+ * @param buffer Buffer of GRID_PRELOAD_READ_CHUNK bytes used for reading.
+ * @return Number of bytes read, 0 if the file does not exist.
+ */
+static uint64 ReadAheadFile(std::string const& fileName, char* buffer)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+    {
+        return 0;
+    }
+
+    uint64 total = 0;
+    size_t count;
+    while ((count = fread(buffer, 1, GRID_PRELOAD_READ_CHUNK, file)) > 0)
+    {
+        total += count;
+    }
+
+    fclose(file);
+    return total;
+}
+
+/**
+ * @brief A request to read the terrain files of a grid.
+ */
+class GridPreloadRequest : public ACE_Method_Request
+{
+    private:
+        GridPreloader& m_preloader; ///< Reference to the grid preloader.
+        uint32 m_mapId; ///< Id of the map the grid belongs to.
+        uint32 m_gx; ///< Terrain grid X coordinate.
+        uint32 m_gy; ///< Terrain grid Y coordinate.
+        bool m_vmaps; ///< Whether vmap tiles are loaded with the grid.
+        bool m_mmaps; ///< Whether mmap tiles are loaded with the grid.
+
+    public:
+        /**
+         * @brief Constructor for GridPreloadRequest.
+         * @param p Reference to the grid preloader.
+         * @param mapId Id of the map.
+         * @param gx Terrain grid X coordinate.
+         * @param gy Terrain grid Y coordinate.
+         * @param vmaps Whether the vmap tile should be read.
+         * @param mmaps Whether the mmap tile should be read.
+         */
+        GridPreloadRequest(GridPreloader& p, uint32 mapId, uint32 gx, uint32 gy, bool vmaps, bool mmaps)
+            : m_preloader(p), m_mapId(mapId), m_gx(gx), m_gy(gy), m_vmaps(vmaps), m_mmaps(mmaps)
+        {
+        }
+
+        /**
+         * @brief Reads the files of the grid.
+         * @return Always returns 0.
+         */
+        virtual int call()
+        {
+            std::string const& dataPath = sWorld.GetDataPath();
+            char fileName[32];
+            char buffer[GRID_PRELOAD_READ_CHUNK];
+            uint64 bytes = 0;
+
+            // same names as used by TerrainInfo::LoadMapAndVMap, the vmap and mmap tiles use swapped grid order
+            snprintf(fileName, sizeof(fileName), "maps/%04u%02u%02u.map", m_mapId, m_gx, m_gy);
+            bytes += ReadAheadFile(dataPath + fileName, buffer);
+
+            if (m_vmaps)
+            {
+                snprintf(fileName, sizeof(fileName), "vmaps/%04u_%02u_%02u.vmtile", m_mapId, m_gy, m_gx);
+                bytes += ReadAheadFile(dataPath + fileName, buffer);
+            }
+
+            if (m_mmaps)
+            {
+                snprintf(fileName, sizeof(fileName), "mmaps/%04u%02u%02u.mmtile", m_mapId, m_gy, m_gx);
+                bytes += ReadAheadFile(dataPath + fileName, buffer);
+            }
+
+            m_preloader.preload_finished(PackGridKey(m_mapId, m_gx, m_gy), bytes);
+            return 0;
+        }
+};
+
+/**
+ * @brief Constructor for GridPreloader.
+ */
+GridPreloader::GridPreloader():
+m_executor(), m_mutex(), m_preloadedGrids(0), m_preloadedBytes(0)
+{
+}
+
+/**
+ * @brief Destructor for GridPreloader.
+ */
+GridPreloader::~GridPreloader()
+{
+    deactivate();
+}
+
+/**
+ * @brief Activates the grid preloader with a single worker thread.
+ * @return Result of the activation.
+ */
+int GridPreloader::activate()
+{
+    return m_executor._activate(1);
+}
+
+/**
+ * @brief Deactivates the grid preloader.
+ * @return Result of the deactivation.
+ */
+int GridPreloader::deactivate()
+{
+    return m_executor.deactivate();
+}
+
+/**
+ * @brief Checks if the grid preloader is activated.
+ * @return True if activated, false otherwise.
+ */
+bool GridPreloader::activated()
+{
+    return m_executor.activated();
+}
+
+/**
+ * @brief Queues the terrain files of a grid to be read.
+ * @param mapId Id of the map the grid belongs to.
+ * @param gx Terrain grid X coordinate (0-63).
+ * @param gy Terrain grid Y coordinate (0-63).
+ * @return True if the request was queued, false if it was already pending or failed.
+ */
+bool GridPreloader::schedule_preload(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!activated())
+    {
+        return false;
+    }
+
+    uint32 key = PackGridKey(mapId, gx, gy);
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, false);
+
+    if (!m_pending.insert(key).second)
+    {
+        return false;
+    }
+
+    bool vmaps = VMAP::VMapFactory::createOrGetVMapManager()->isMapLoadingEnabled();
+    bool mmaps = sWorld.getConfig(CONFIG_BOOL_MMAP_ENABLED);
+
+    if (m_executor.execute(new GridPreloadRequest(*this, mapId, gx, gy, vmaps, mmaps)) == -1)
+    {
+        sLog.outError("GridPreloader: Failed to schedule preload of grid [%u,%u] on map %u", gx, gy, mapId);
+        m_pending.erase(key);
+        return false;
+    }
+
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "GridPreloader: Scheduled preload of grid [%u,%u] on map %u", gx, gy, mapId);
+    return true;
+}
+
+/**
+ * @brief Returns the number of grids whose files were read ahead.
+ * @return Number of preloaded grids.
+ */
+uint32 GridPreloader::GetPreloadedGridCount() const
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, 0);
+    return m_preloadedGrids;
+}
+
+/**
+ * @brief Returns the number of bytes read ahead.
+ * @return Number of preloaded bytes.
+ */
+uint64 GridPreloader::GetPreloadedBytes() const
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, 0);
+    return m_preloadedBytes;
+}
+
+/**
+ * @brief Called by the worker when the files of a grid were read.
+ * @param key Packed key of the grid.
+ * @param bytes Number of bytes read.
+ */
+void GridPreloader::preload_finished(uint32 key, uint64 bytes)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    m_pending.erase(key);
+    ++m_preloadedGrids;
+    m_preloadedBytes += bytes;
+}
@@ -0,0 +1,123 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file GridPreloader.h
+ * @brief Header file for the GridPreloader class.
+ *
+ * This file contains the definition of the GridPreloader class which reads the
+ * terrain files of grids ahead of moving players on a background thread. It includes:
+ * - Deduplication of pending preload requests
+ * - Thread management for the read-ahead worker
+ * - Statistics about the preloaded grids
+ */
+
+#ifndef _GRID_PRELOADER_H_INCLUDED
+#define _GRID_PRELOADER_H_INCLUDED
+
+#include <ace/Thread_Mutex.h>
+#include <set>
+
+#include "Common.h"
+#include "DelayExecutor.h"
+
+/**
+ * @brief The GridPreloader class reads the terrain files of a grid ahead of its loading.
+ *
+ * Loading the .map, vmap and mmap tiles of a grid must stay on the map thread,
+ * because the vmap and mmap managers are not thread-safe. The expensive part of
+ * a cold load is however the disk access, so the preloader reads the files of
+ * the grids a player is heading to, and the map thread later finds them in the
+ * file system cache.
+ */
+class GridPreloader
+{
+    public:
+        /**
+         * @brief Constructor for GridPreloader.
+         */
+        GridPreloader();
+
+        /**
+         * @brief Destructor for GridPreloader.
+         */
+        virtual ~GridPreloader();
+
+        friend class GridPreloadRequest;
+
+        /**
+         * @brief Queues the terrain files of a grid to be read.
+         * @param mapId Id of the map the grid belongs to.
+         * @param gx Terrain grid X coordinate (0-63).
+         * @param gy Terrain grid Y coordinate (0-63).
+         * @return True if the request was queued, false if it was already pending or failed.
+         */
+        bool schedule_preload(uint32 mapId, uint32 gx, uint32 gy);
+
+        /**
+         * @brief Activates the grid preloader with a single worker thread.
+         * @return Result of the activation.
+         */
+        int activate();
+
+        /**
+         * @brief Deactivates the grid preloader.
+         * @return Result of the deactivation.
+         */
+        int deactivate();
+
+        /**
+         * @brief Checks if the grid preloader is activated.
+         * @return True if activated, false otherwise.
+         */
+        bool activated();
+
+        /**
+         * @brief Returns the number of grids whose files were read ahead.
+         * @return Number of preloaded grids.
+         */
+        uint32 GetPreloadedGridCount() const;
+
+        /**
+         * @brief Returns the number of bytes read ahead.
+         * @return Number of preloaded bytes.
+         */
+        uint64 GetPreloadedBytes() const;
+
+    private:
+        DelayExecutor m_executor; ///< Executor running the read-ahead worker.
+        mutable ACE_Thread_Mutex m_mutex; ///< Mutex for synchronizing access to pending requests and statistics.
+        std::set<uint32> m_pending; ///< Packed keys of the grids queued but not read yet.
+        uint32 m_preloadedGrids; ///< Number of grids read ahead.
+        uint64 m_preloadedBytes; ///< Number of bytes read ahead.
+
+        /**
+         * @brief Called by the worker when the files of a grid were read.
+         * @param key Packed key of the grid.
+         * @param bytes Number of bytes read.
+         */
+        void preload_finished(uint32 key, uint64 bytes);
+};
+
+#endif //_GRID_PRELOADER_H_INCLUDED
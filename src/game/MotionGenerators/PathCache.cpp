@@ -0,0 +1,154 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "PathCache.h"
+
+#include <algorithm>
+
+PathCache::PathCache() : m_hits(0), m_misses(0)
+{
+}
+
+uint32 PathCache::Lookup(dtPolyRef startPoly, dtPolyRef endPoly, uint32 filterKey, uint32 now, dtPolyRef* path, uint32 maxPath)
+{
+    CorridorMap::const_iterator itr = m_corridors.find(EndKey(endPoly, filterKey));
+    if (itr != m_corridors.end())
+    {
+        for (Corridors::const_iterator corridor = itr->second.begin(); corridor != itr->second.end(); ++corridor)
+        {
+            if (IsExpired(*corridor, now))
+            {
+                continue;
+            }
+
+            std::vector<dtPolyRef> const& polys = corridor->polys;
+            for (uint32 i = 0; i < polys.size(); ++i)
+            {
+                if (polys[i] != startPoly)
+                {
+                    continue;
+                }
+
+                uint32 length = polys.size() - i;
+                if (length > maxPath)
+                {
+                    break;
+                }
+
+                std::copy(polys.begin() + i, polys.end(), path);
+                ++m_hits;
+                return length;
+            }
+        }
+    }
+
+    ++m_misses;
+    return 0;
+}
+
+void PathCache::Store(const dtPolyRef* path, uint32 length, uint32 filterKey, uint32 now, uint32 lifetime)
+{
+    if (length < 2)
+    {
+        return;
+    }
+
+    EndKey key(path[length - 1], filterKey);
+    CorridorMap::iterator itr = m_corridors.find(key);
+    if (itr == m_corridors.end())
+    {
+        if (m_corridors.size() >= PATH_CACHE_MAX_ENDS)
+        {
+            PurgeExpired(now);
+        }
+
+        if (m_corridors.size() >= PATH_CACHE_MAX_ENDS)
+        {
+            return;
+        }
+
+        itr = m_corridors.insert(CorridorMap::value_type(key, Corridors())).first;
+    }
+
+    // replace the corridor from the same start, else the one expiring first
+    Corridors& corridors = itr->second;
+    Corridor* slot = NULL;
+    for (Corridors::iterator corridor = corridors.begin(); corridor != corridors.end(); ++corridor)
+    {
+        if (corridor->polys.front() == path[0])
+        {
+            slot = &*corridor;
+            break;
+        }
+
+        if (!slot || int32(corridor->expireTime - slot->expireTime) < 0)
+        {
+            slot = &*corridor;
+        }
+    }
+
+    if (corridors.size() < PATH_CACHE_CORRIDORS_PER_END && (!slot || slot->polys.front() != path[0]))
+    {
+        corridors.push_back(Corridor());
+        slot = &corridors.back();
+    }
+
+    slot->polys.assign(path, path + length);
+    slot->expireTime = now + lifetime;
+}
+
+void PathCache::Clear()
+{
+    m_corridors.clear();
+}
+
+/**
+ * @brief Drops every end polygon whose corridors have all expired.
+ *
+ * @param now The current time in milliseconds.
+ */
+void PathCache::PurgeExpired(uint32 now)
+{
+    for (CorridorMap::iterator itr = m_corridors.begin(); itr != m_corridors.end();)
+    {
+        bool expired = true;
+        for (Corridors::const_iterator corridor = itr->second.begin(); corridor != itr->second.end(); ++corridor)
+        {
+            if (!IsExpired(*corridor, now))
+            {
+                expired = false;
+                break;
+            }
+        }
+
+        if (expired)
+        {
+            m_corridors.erase(itr++);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_PATHCACHE_H
+#define MANGOS_PATHCACHE_H
+
+#include "Platform/Define.h"
+#include "DetourNavMesh.h"
+
+#include <map>
+#include <vector>
+
+/// Number of corridors kept toward the same end polygon
+#define PATH_CACHE_CORRIDORS_PER_END    4
+/// Number of end polygons a cache holds before expired corridors are purged
+#define PATH_CACHE_MAX_ENDS             512
+
+/**
+ * @brief Caches polygon corridors found by PathFinder on a map.
+ *
+ * A pull of many creatures chasing the same target runs the same A* search
+ * again and again. Corridors are grouped by their end polygon and query
+ * filter: a unit standing on any polygon of a cached corridor toward the
+ * same end polygon reuses the rest of that corridor, a sub-path of an
+ * optimal path is optimal as well.
+ *
+ * Corridors expire after a short time, the target usually moves on anyway.
+ * Not thread-safe, a cache belongs to the map that updates it.
+ */
+class PathCache
+{
+    public:
+        /**
+         * @brief Constructor for PathCache.
+         */
+        PathCache();
+
+        /**
+         * @brief Looks up a corridor from a polygon to an end polygon.
+         *
+         * @param startPoly The polygon the unit stands on.
+         * @param endPoly The polygon of the destination.
+         * @param filterKey The include and exclude flags of the query filter.
+         * @param now The current time in milliseconds.
+         * @param path Receives the corridor, starting with startPoly.
+         * @param maxPath The capacity of path.
+         * @return The length of the corridor, 0 if none was cached or it does not fit.
+         */
+        uint32 Lookup(dtPolyRef startPoly, dtPolyRef endPoly, uint32 filterKey, uint32 now, dtPolyRef* path, uint32 maxPath);
+
+        /**
+         * @brief Stores a complete corridor, its last polygon is the end polygon.
+         *
+         * @param path The corridor.
+         * @param length The length of the corridor.
+         * @param filterKey The include and exclude flags of the query filter.
+         * @param now The current time in milliseconds.
+         * @param lifetime The time in milliseconds the corridor stays valid.
+         */
+        void Store(const dtPolyRef* path, uint32 length, uint32 filterKey, uint32 now, uint32 lifetime);
+
+        /**
+         * @brief Drops all cached corridors.
+         */
+        void Clear();
+
+        uint64 GetHits() const { return m_hits; }
+        uint64 GetMisses() const { return m_misses; }
+
+    private:
+        struct Corridor
+        {
+            std::vector<dtPolyRef> polys;
+            uint32 expireTime;
+        };
+
+        typedef std::pair<dtPolyRef, uint32> EndKey;        // end polygon, filter key
+        typedef std::vector<Corridor> Corridors;
+        typedef std::map<EndKey, Corridors> CorridorMap;
+
+        static bool IsExpired(const Corridor& corridor, uint32 now) { return int32(corridor.expireTime - now) <= 0; }
+
+        void PurgeExpired(uint32 now);
+
+        CorridorMap m_corridors;
+        uint64 m_hits;
+        uint64 m_misses;
+};
+
+#endif
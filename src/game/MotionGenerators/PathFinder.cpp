@@ -29,6 +29,10 @@
 #include "Creature.h"
 #include "PathFinder.h"
 #include "Log.h"
+#include "World.h"
+#include "Map.h"
+#include "GameTime.h"
+#include "CollisionProfiler.h"
 
 ////////////////// PathFinder //////////////////
 
@@ -43,12 +47,12 @@ PathFinder::PathFinder(const Unit* owner) :
 {
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
+    m_pathPolyRefs.resize(MAX_PATH_LENGTH, INVALID_POLYREF);
+
     uint32 mapId = m_sourceUnit->GetMapId();
     if (MMAP::MMapFactory::IsPathfindingEnabled(mapId, owner))
     {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
+        m_navMesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(mapId);
     }
 
     createFilter();
@@ -72,6 +76,8 @@ PathFinder::~PathFinder()
  */
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
 {
+    CollisionProfileScope profileScope(COLLISION_QUERY_PATH);
+
     // Vector3 oldDest = getEndPosition();
     Vector3 dest(destX, destY, destZ);
     setEndPosition(dest);
@@ -85,10 +91,37 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
 
+    // the map may be updated by a different thread than last time, use the query of this one
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    ACE_RW_Thread_Mutex* queryLock = NULL;
+    if (m_navMesh)
+    {
+        m_navMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId());
+        queryLock = mmap->GetQueryLock(m_sourceUnit->GetMapId());
+    }
+
     // make sure navMesh works - we can run on map w/o mmap
+    if (!m_navMesh || !m_navMeshQuery || !queryLock || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING))
+    {
+        BuildShortcut();
+        m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        return true;
+    }
+
+    // the tiles between start and end are marked used and evicted ones come back, before the query lock is taken
+    int startTileX, startTileY, endTileX, endTileY;
+    float startPoint[VERTEX_SIZE] = {start.y, start.z, start.x};
+    float endPoint[VERTEX_SIZE] = {dest.y, dest.z, dest.x};
+    m_navMesh->calcTileLoc(startPoint, &startTileX, &startTileY);
+    m_navMesh->calcTileLoc(endPoint, &endTileX, &endTileY);
+    mmap->acquireTiles(m_sourceUnit->GetMapId(), std::min(startTileX, endTileX), std::min(startTileY, endTileY),
+                       std::max(startTileX, endTileX), std::max(startTileY, endTileY));
+
+    // no tile is added or removed while the path is built
+    MMAP::NavMeshReadGuard guard(*queryLock);
+
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
-    if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
-        !HaveTile(start) || !HaveTile(dest))
+    if (!HaveTile(start) || !HaveTile(dest))
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
@@ -98,6 +131,26 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
     updateFilter();
 
     BuildPolyPath(start, dest);
+
+    // a corridor may leave the area between start and end, its tiles must not age out either
+    std::vector<std::pair<int32, int32> > tiles;
+    for (uint32 i = 0; i < m_polyLength; ++i)
+    {
+        const dtMeshTile* tile = NULL;
+        const dtPoly* poly = NULL;
+        if (dtStatusFailed(m_navMesh->getTileAndPolyByRef(m_pathPolyRefs[i], &tile, &poly)))
+        {
+            continue;
+        }
+
+        std::pair<int32, int32> tileLoc(tile->header->x, tile->header->y);
+        if (std::find(tiles.begin(), tiles.end(), tileLoc) == tiles.end())
+        {
+            tiles.push_back(tileLoc);
+        }
+    }
+
+    mmap->touchTiles(m_sourceUnit->GetMapId(), tiles);
     return true;
 }
 
@@ -162,7 +215,7 @@ dtPolyRef PathFinder::getPolyByLocation(const float* point, float* distance) con
     // first we check the current path
     // if the current path doesn't contain the current poly,
     // we need to use the expensive navMesh.findNearestPoly
-    dtPolyRef polyRef = getPathPolyByPosition(m_pathPolyRefs, m_polyLength, point, distance);
+    dtPolyRef polyRef = getPathPolyByPosition(&m_pathPolyRefs[0], m_polyLength, point, distance);
     if (polyRef != INVALID_POLYREF)
     {
         return polyRef;
@@ -193,6 +246,91 @@ dtPolyRef PathFinder::getPolyByLocation(const float* point, float* distance) con
     return INVALID_POLYREF;
 }
 
+/**
+ * @brief Grows the polygon path buffer after detour reported it too small.
+ *
+ * The buffer doubles up to mmap.maxPathLength, so long chases get a full
+ * path instead of an incomplete one that is recalculated over and over.
+ *
+ * @return True if the buffer grew, false if it already has the configured maximum size.
+ */
+bool PathFinder::growPolyPath()
+{
+    uint32 maxLength = sWorld.getConfig(CONFIG_UINT32_MMAP_MAX_PATH_LENGTH);
+    if (m_pathPolyRefs.size() >= maxLength)
+    {
+        return false;
+    }
+
+    m_pathPolyRefs.resize(std::min<size_t>(m_pathPolyRefs.size() * 2, maxLength), INVALID_POLYREF);
+    return true;
+}
+
+/**
+ * @brief Finds the polygon corridor between two polygons.
+ *
+ * Corridors are shared through the path cache of the map: a unit standing on
+ * a corridor another unit recently found toward the same end polygon takes the
+ * rest of it instead of running its own search. The buffer grows while detour
+ * reports it too small.
+ *
+ * @param startPoly The start polygon.
+ * @param endPoly The end polygon.
+ * @param startPoint A position on the start polygon.
+ * @param endPoint A position on the end polygon.
+ * @param offset The index of m_pathPolyRefs the corridor is written at.
+ * @param pathLength Receives the length of the corridor.
+ * @return The status of the search.
+ */
+dtStatus PathFinder::findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint,
+                                  uint32 offset, uint32& pathLength)
+{
+    uint32 cacheTime = sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_CACHE_TIME);
+    PathCache& cache = m_sourceUnit->GetMap()->GetPathCache();
+    uint32 filterKey = uint32(m_filter.getIncludeFlags()) | (uint32(m_filter.getExcludeFlags()) << 16);
+    uint32 now = GameTime::GetGameTimeMS();
+
+    if (cacheTime)
+    {
+        pathLength = cache.Lookup(startPoly, endPoly, filterKey, now, &m_pathPolyRefs[offset], m_pathPolyRefs.size() - offset);
+
+        // tiles may have been unloaded since the corridor was found
+        bool valid = pathLength != 0;
+        for (uint32 i = 0; valid && i < pathLength; ++i)
+        {
+            valid = m_navMesh->isValidPolyRef(m_pathPolyRefs[offset + i]);
+        }
+
+        if (valid)
+        {
+            return DT_SUCCESS;
+        }
+    }
+
+    dtStatus dtResult;
+    do
+    {
+        dtResult = m_navMeshQuery->findPath(
+                       startPoly,          // start polygon
+                       endPoly,            // end polygon
+                       startPoint,         // start position
+                       endPoint,           // end position
+                       &m_filter,          // polygon search filter
+                       &m_pathPolyRefs[offset], // [out] path
+                       (int*)&pathLength,
+                       m_pathPolyRefs.size() - offset); // max number of polygons in output path
+    }
+    while (dtStatusDetail(dtResult, DT_BUFFER_TOO_SMALL) && growPolyPath());
+
+    // only complete corridors are worth sharing
+    if (cacheTime && dtStatusSucceed(dtResult) && pathLength > 1 && m_pathPolyRefs[offset + pathLength - 1] == endPoly)
+    {
+        cache.Store(&m_pathPolyRefs[offset], pathLength, filterKey, now, cacheTime);
+    }
+
+    return dtResult;
+}
+
 /**
  * @brief Builds the polygon path from the start position to the end position.
  * @param startPos The start position.
@@ -348,7 +486,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // just "cut" it out
 
         m_polyLength = pathEndIndex - pathStartIndex + 1;
-        memmove(m_pathPolyRefs, m_pathPolyRefs + pathStartIndex, m_polyLength * sizeof(dtPolyRef));
+        memmove(&m_pathPolyRefs[0], &m_pathPolyRefs[pathStartIndex], m_polyLength * sizeof(dtPolyRef));
     }
     else if (startPolyFound && !endPolyFound)
     {
@@ -367,7 +505,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // take ~80% of the original length
         // TODO : play with the values here
         uint32 prefixPolyLength = uint32(m_polyLength * 0.8f + 0.5f);
-        memmove(m_pathPolyRefs, m_pathPolyRefs + pathStartIndex, prefixPolyLength * sizeof(dtPolyRef));
+        memmove(&m_pathPolyRefs[0], &m_pathPolyRefs[pathStartIndex], prefixPolyLength * sizeof(dtPolyRef));
 
         dtPolyRef suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
 
@@ -392,15 +530,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         // generate suffix
         uint32 suffixPolyLength = 0;
-        dtResult = m_navMeshQuery->findPath(
-                       suffixStartPoly,    // start polygon
-                       endPoly,            // end polygon
-                       suffixEndPoint,     // start position
-                       endPoint,           // end position
-                       &m_filter,            // polygon search filter
-                       m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
-                       (int*)&suffixPolyLength,
-                       MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
+        dtResult = findPolyPath(suffixStartPoly, endPoly, suffixEndPoint, endPoint, prefixPolyLength - 1, suffixPolyLength);
 
         if (!suffixPolyLength || dtStatusFailed(dtResult))
         {
@@ -427,15 +557,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
-                       startPoly,          // start polygon
-                       endPoly,            // end polygon
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       &m_filter,           // polygon search filter
-                       m_pathPolyRefs,     // [out] path
-                       (int*)&m_polyLength,
-                       MAX_PATH_LENGTH);   // max number of polygons in output path
+        dtResult = findPolyPath(startPoly, endPoly, startPoint, endPoint, 0, m_polyLength);
 
         if (!m_polyLength || dtStatusFailed(dtResult))
         {
@@ -476,7 +598,7 @@ void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
         dtResult = m_navMeshQuery->findStraightPath(
                        startPoint,         // start position
                        endPoint,           // end position
-                       m_pathPolyRefs,     // current path
+                       &m_pathPolyRefs[0], // current path
                        m_polyLength,       // length of current path
                        pathPoints,         // [out] path corner points
                        NULL,               // [out] flags
@@ -489,7 +611,7 @@ void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
         dtResult = findSmoothPath(
                        startPoint,         // start position
                        endPoint,           // end position
-                       m_pathPolyRefs,     // current path
+                       &m_pathPolyRefs[0], // current path
                        m_polyLength,       // length of current path
                        pathPoints,         // [out] path corner points
                        (int*)&pointCount,
@@ -653,7 +775,7 @@ NavTerrain PathFinder::getNavTerrain(float x, float y, float z)
 }
 
 /**
- * @brief Checks if the specified point has a tile in the navigation mesh.
+ * @brief Checks if the specified point has a tile in the navigation mesh, the query lock of the navmesh must be held.
  * @param p The point to check.
  * @return True if the point has a tile, false otherwise.
  */
@@ -804,8 +926,11 @@ dtStatus PathFinder::findSmoothPath(const float* startPos, const float* endPos,
     *smoothPathSize = 0;
     uint32 nsmoothPath = 0;
 
-    dtPolyRef polys[MAX_PATH_LENGTH];
-    memcpy(polys, polyPath, sizeof(dtPolyRef)*polyPathSize);
+    // the corridor shrinks and grows while moving along it, give it the capacity of the whole path
+    m_smoothPolyRefs.assign(polyPath, polyPath + polyPathSize);
+    m_smoothPolyRefs.resize(std::max<size_t>(m_pathPolyRefs.size(), polyPathSize), INVALID_POLYREF);
+    dtPolyRef* polys = &m_smoothPolyRefs[0];
+    uint32 maxPolys = m_smoothPolyRefs.size();
     uint32 npolys = polyPathSize;
 
     float iterPos[VERTEX_SIZE], targetPos[VERTEX_SIZE];
@@ -865,7 +990,7 @@ dtStatus PathFinder::findSmoothPath(const float* startPos, const float* endPos,
 
         uint32 nvisited = 0;
         m_navMeshQuery->moveAlongSurface(polys[0], iterPos, moveTgt, &m_filter, result, visited, (int*)&nvisited, MAX_VISIT_POLY);
-        npolys = fixupCorridor(polys, npolys, MAX_PATH_LENGTH, visited, nvisited);
+        npolys = fixupCorridor(polys, npolys, maxPolys, visited, nvisited);
 
         m_navMeshQuery->getPolyHeight(polys[0], result, &result[1]);
         result[1] += 0.5f;
@@ -39,6 +39,7 @@ class Unit;
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
 // I think we can safely cut those down even more
+// polygon paths start with MAX_PATH_LENGTH and grow up to mmap.maxPathLength when needed
 #define MAX_PATH_LENGTH         74
 #define MAX_POINT_PATH_LENGTH   74
 
@@ -135,7 +136,8 @@ class PathFinder
 
     private:
 
-        dtPolyRef      m_pathPolyRefs[MAX_PATH_LENGTH];   // Array of detour polygon references
+        std::vector<dtPolyRef> m_pathPolyRefs;            // Array of detour polygon references, its size is the capacity
+        std::vector<dtPolyRef> m_smoothPolyRefs;          // Corridor scratch buffer of findSmoothPath
         uint32         m_polyLength;                      // Number of polygons in the path
 
         PointsArray    m_pathPoints;       // Our actual (x,y,z) path to the target
@@ -151,7 +153,7 @@ class PathFinder
 
         const Unit* const       m_sourceUnit;       // The unit that is moving
         const dtNavMesh*        m_navMesh;          // The navigation mesh
-        const dtNavMeshQuery*   m_navMeshQuery;     // The navigation mesh query used to find the path
+        const dtNavMeshQuery*   m_navMeshQuery;     // The navigation mesh query of the calculating thread
 
         dtQueryFilter m_filter;                     // Use a single filter for all movements, update it when needed
 
@@ -229,12 +231,31 @@ class PathFinder
         dtPolyRef getPolyByLocation(const float* point, float* distance) const;
 
         /**
-         * @brief Check if a tile exists at the given position.
+         * @brief Check if a tile exists at the given position, the query lock of the navmesh must be held.
          * @param p The position.
          * @return True if the tile exists, false otherwise.
          */
         bool HaveTile(const Vector3& p) const;
 
+        /**
+         * @brief Grow the polygon path buffer after detour reported it too small.
+         * @return True if the buffer grew, false if it already has the configured maximum size.
+         */
+        bool growPolyPath();
+
+        /**
+         * @brief Find the polygon corridor between two polygons, using the path cache of the map.
+         * @param startPoly The start polygon.
+         * @param endPoly The end polygon.
+         * @param startPoint A position on the start polygon.
+         * @param endPoint A position on the end polygon.
+         * @param offset The index of the path buffer the corridor is written at.
+         * @param pathLength Receives the length of the corridor.
+         * @return The status of the search.
+         */
+        dtStatus findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint,
+                              uint32 offset, uint32& pathLength);
+
         /**
          * @brief Build the polygon path.
          * @param startPos The start position.
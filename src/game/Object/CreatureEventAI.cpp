@@ -206,10 +206,43 @@ CreatureEventAI::CreatureEventAI(Creature* c) : CreatureAI(c),
     {
         sLog.outErrorEventAI("EventMap for Creature %u is empty but creature is using CreatureEventAI.", m_creature->GetEntry());
     }
+
+    BuildEventTypeIndex();
+
     // Handle Spawned Events, also calls Reset()
     JustRespawned();
 }
 
+/**
+ * @brief Groups the indexes of the creature's events by event type.
+ *
+ * Keeps the original order of events of the same type, so event handlers
+ * process them in the same order as a scan of the full list would.
+ */
+void CreatureEventAI::BuildEventTypeIndex()
+{
+    uint16 typeCount[EVENT_T_END] = { 0 };
+    for (CreatureEventAIList::const_iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
+    {
+        ++typeCount[itr->Event.event_type];
+    }
+
+    m_EventTypeOffset[0] = 0;
+    for (uint32 type = 0; type < EVENT_T_END; ++type)
+    {
+        m_EventTypeOffset[type + 1] = m_EventTypeOffset[type] + typeCount[type];
+    }
+
+    m_EventIndexByType.resize(m_CreatureEventAIList.size());
+
+    uint16 fillPos[EVENT_T_END];
+    memcpy(fillPos, m_EventTypeOffset, sizeof(fillPos));
+    for (uint16 i = 0; i < m_CreatureEventAIList.size(); ++i)
+    {
+        m_EventIndexByType[fillPos[m_CreatureEventAIList[i].Event.event_type]++] = i;
+    }
+}
+
 #define LOG_PROCESS_EVENT                                                                                                       \
     DEBUG_FILTER_LOG(LOG_FILTER_EVENT_AI_DEV, "CreatureEventAI: Event type %u (script %u) triggered for %s (invoked by %s)",    \
                      pHolder.Event.event_type, pHolder.Event.event_id, m_creature->GetGuidStr().c_str(), pActionInvoker ? pActionInvoker->GetGuidStr().c_str() : "<no invoker>")
@@ -415,9 +448,16 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
             }
 
+            // A recent search found nothing, do not scan the grid again yet
+            if (pHolder.SearchDelay)
+            {
+                return false;
+            }
+
             Unit* pUnit = DoSelectLowestHpFriendly((float)event.friendly_hp.radius, event.friendly_hp.hpDeficit);
             if (!pUnit)
             {
+                pHolder.SearchDelay = EVENT_FRIENDLY_SEARCH_DELAY;
                 return false;
             }
 
@@ -435,17 +475,24 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
                 return false;
             }
 
-            std::list<Creature*> pList;
-            DoFindFriendlyCC(pList, (float)event.friendly_is_cc.radius);
+            if (pHolder.SearchDelay)
+            {
+                return false;
+            }
 
-            // List is empty
-            if (pList.empty())
+            // We don't really care about all matching creatures, just take the first available
+            Creature* pCreature = NULL;
+            MaNGOS::FriendlyCCedInRangeCheck u_check(m_creature, (float)event.friendly_is_cc.radius);
+            MaNGOS::CreatureSearcher<MaNGOS::FriendlyCCedInRangeCheck> searcher(pCreature, u_check);
+            Cell::VisitGridObjects(m_creature, searcher, (float)event.friendly_is_cc.radius);
+
+            if (!pCreature)
             {
+                pHolder.SearchDelay = EVENT_FRIENDLY_SEARCH_DELAY;
                 return false;
             }
 
-            // We don't really care about the whole list, just return first available
-            pActionInvoker = *(pList.begin());
+            pActionInvoker = pCreature;
 
             LOG_PROCESS_EVENT;
             // Repeat Timers
@@ -454,17 +501,24 @@ bool CreatureEventAI::ProcessEvent(CreatureEventAIHolder& pHolder, Unit* pAction
         }
         case EVENT_T_FRIENDLY_MISSING_BUFF:
         {
-            std::list<Creature*> pList;
-            DoFindFriendlyMissingBuff(pList, (float)event.friendly_buff.radius, event.friendly_buff.spellId);
+            if (pHolder.SearchDelay)
+            {
+                return false;
+            }
+
+            // We don't really care about all matching creatures, just take the first available
+            Creature* pCreature = NULL;
+            MaNGOS::FriendlyMissingBuffInRangeCheck u_check(m_creature, (float)event.friendly_buff.radius, event.friendly_buff.spellId);
+            MaNGOS::CreatureSearcher<MaNGOS::FriendlyMissingBuffInRangeCheck> searcher(pCreature, u_check);
+            Cell::VisitGridObjects(m_creature, searcher, (float)event.friendly_buff.radius);
 
-            // List is empty
-            if (pList.empty())
+            if (!pCreature)
             {
+                pHolder.SearchDelay = EVENT_FRIENDLY_SEARCH_DELAY;
                 return false;
             }
 
-            // We don't really care about the whole list, just return first available
-            pActionInvoker = *(pList.begin());
+            pActionInvoker = pCreature;
 
             // Repeat Timers
             pHolder.UpdateRepeatTimer(m_creature, event.friendly_buff.repeatMin, event.friendly_buff.repeatMax);
@@ -944,10 +998,12 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
             break;
         case ACTION_T_THREAT_ALL_PCT:       //14
         {
-            ThreatList const& threatList = m_creature->GetThreatManager().getThreatList();
-            for (ThreatList::const_iterator i = threatList.begin(); i != threatList.end(); ++i)
+            // modifying threat may add (pet owners) or move references, so the threat list is not walked directly
+            GuidVector guids;
+            m_creature->FillGuidsListFromThreatList(guids);
+            for (GuidVector::const_iterator i = guids.begin(); i != guids.end(); ++i)
             {
-                if (Unit* Temp = m_creature->GetMap()->GetUnit((*i)->getUnitGuid()))
+                if (Unit* Temp = m_creature->GetMap()->GetUnit(*i))
                 {
                     m_creature->GetThreatManager().modifyThreatPercent(Temp, action.threat_all_pct.percent);
                 }
@@ -1457,6 +1513,9 @@ void CreatureEventAI::Reset()
     // Reset all events to enabled
     for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
     {
+        // a friendly search that failed before the evade or death may run again right away
+        i->SearchDelay = 0;
+
         CreatureEventAI_Event const& event = i->Event;
         switch (event.event_type)
         {
@@ -1483,12 +1542,9 @@ void CreatureEventAI::Reset()
  */
 void CreatureEventAI::JustReachedHome()
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_REACHED_HOME]; idx < m_EventTypeOffset[EVENT_T_REACHED_HOME + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_REACHED_HOME)
-        {
-            ProcessEvent(*i);
-        }
+        ProcessEvent(m_CreatureEventAIList[m_EventIndexByType[idx]]);
     }
 
     Reset();
@@ -1511,12 +1567,9 @@ void CreatureEventAI::EnterEvadeMode()
     m_creature->SetLootRecipient(NULL);
 
     // Handle Evade events
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_EVADE]; idx < m_EventTypeOffset[EVENT_T_EVADE + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_EVADE)
-        {
-            ProcessEvent(*i);
-        }
+        ProcessEvent(m_CreatureEventAIList[m_EventIndexByType[idx]]);
     }
     m_creature->ResetPlayerDamageReq();
 }
@@ -1545,12 +1598,9 @@ void CreatureEventAI::JustDied(Unit* killer)
     }
 
     // Handle On Death events
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_DEATH]; idx < m_EventTypeOffset[EVENT_T_DEATH + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_DEATH)
-        {
-            ProcessEvent(*i, killer);
-        }
+        ProcessEvent(m_CreatureEventAIList[m_EventIndexByType[idx]], killer);
     }
 
     // reset phase after any death state events
@@ -1569,12 +1619,9 @@ void CreatureEventAI::KilledUnit(Unit* victim)
         return;
     }
 
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_KILL]; idx < m_EventTypeOffset[EVENT_T_KILL + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_KILL)
-        {
-            ProcessEvent(*i, victim);
-        }
+        ProcessEvent(m_CreatureEventAIList[m_EventIndexByType[idx]], victim);
     }
 }
 
@@ -1585,12 +1632,9 @@ void CreatureEventAI::KilledUnit(Unit* victim)
  */
 void CreatureEventAI::JustSummoned(Creature* pUnit)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_SUMMONED_UNIT]; idx < m_EventTypeOffset[EVENT_T_SUMMONED_UNIT + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_SUMMONED_UNIT)
-        {
-            ProcessEvent(*i, pUnit);
-        }
+        ProcessEvent(m_CreatureEventAIList[m_EventIndexByType[idx]], pUnit);
     }
 }
 
@@ -1601,12 +1645,9 @@ void CreatureEventAI::JustSummoned(Creature* pUnit)
  */
 void CreatureEventAI::SummonedCreatureJustDied(Creature* pUnit)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_SUMMONED_JUST_DIED]; idx < m_EventTypeOffset[EVENT_T_SUMMONED_JUST_DIED + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_SUMMONED_JUST_DIED)
-        {
-            ProcessEvent(*i, pUnit);
-        }
+        ProcessEvent(m_CreatureEventAIList[m_EventIndexByType[idx]], pUnit);
     }
 }
 
@@ -1617,12 +1658,9 @@ void CreatureEventAI::SummonedCreatureJustDied(Creature* pUnit)
  */
 void CreatureEventAI::SummonedCreatureDespawn(Creature* pUnit)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_SUMMONED_JUST_DESPAWN]; idx < m_EventTypeOffset[EVENT_T_SUMMONED_JUST_DESPAWN + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_SUMMONED_JUST_DESPAWN)
-        {
-            ProcessEvent(*i, pUnit);
-        }
+        ProcessEvent(m_CreatureEventAIList[m_EventIndexByType[idx]], pUnit);
     }
 }
 
@@ -1638,13 +1676,13 @@ void CreatureEventAI::ReceiveAIEvent(AIEventType eventType, Creature* pSender, U
 {
     MANGOS_ASSERT(pSender);
 
-    for (CreatureEventAIList::iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_RECEIVE_AI_EVENT]; idx < m_EventTypeOffset[EVENT_T_RECEIVE_AI_EVENT + 1]; ++idx)
     {
-        if (itr->Event.event_type == EVENT_T_RECEIVE_AI_EVENT &&
-            itr->Event.receiveAIEvent.eventType == eventType && (!itr->Event.receiveAIEvent.senderEntry || itr->Event.receiveAIEvent.senderEntry == pSender->GetEntry()))
-            {
-                ProcessEvent(*itr, pInvoker, pSender);
-            }
+        CreatureEventAIHolder& holder = m_CreatureEventAIList[m_EventIndexByType[idx]];
+        if (holder.Event.receiveAIEvent.eventType == eventType && (!holder.Event.receiveAIEvent.senderEntry || holder.Event.receiveAIEvent.senderEntry == pSender->GetEntry()))
+        {
+            ProcessEvent(holder, pInvoker, pSender);
+        }
     }
 }
 
@@ -1676,6 +1714,7 @@ void CreatureEventAI::EnterCombat(Unit* enemy)
             default:
                 i->Enabled = true;
                 i->Time = 0;
+                i->SearchDelay = 0;
                 break;
         }
     }
@@ -1721,22 +1760,27 @@ void CreatureEventAI::MoveInLineOfSight(Unit* who)
     // Check for OOC LOS Event
     if (m_HasOOCLoSEvent && !m_creature->getVictim())
     {
-        for (CreatureEventAIList::iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
+        for (uint16 idx = m_EventTypeOffset[EVENT_T_OOC_LOS]; idx < m_EventTypeOffset[EVENT_T_OOC_LOS + 1]; ++idx)
         {
-            if (itr->Event.event_type == EVENT_T_OOC_LOS)
+            CreatureEventAIHolder& holder = m_CreatureEventAIList[m_EventIndexByType[idx]];
+
+            // skip the distance and LOS checks for events that could not trigger anyway
+            if (!holder.Enabled || holder.Time)
             {
-                // can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (float)itr->Event.ooc_los.maxRange;
+                continue;
+            }
 
-                // if friendly event && who is not hostile OR hostile event && who is hostile
-                if ((itr->Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
-                    ((!itr->Event.ooc_los.noHostile) && m_creature->IsHostileTo(who)))
+            // can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = (float)holder.Event.ooc_los.maxRange;
+
+            // if friendly event && who is not hostile OR hostile event && who is hostile
+            if ((holder.Event.ooc_los.noHostile && !m_creature->IsHostileTo(who)) ||
+                ((!holder.Event.ooc_los.noHostile) && m_creature->IsHostileTo(who)))
+            {
+                // if range is ok and we are actually in LOS
+                if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
                 {
-                    // if range is ok and we are actually in LOS
-                    if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                    {
-                        ProcessEvent(*itr, who);
-                    }
+                    ProcessEvent(holder, who);
                 }
             }
         }
@@ -1780,17 +1824,16 @@ void CreatureEventAI::MoveInLineOfSight(Unit* who)
  */
 void CreatureEventAI::SpellHit(Unit* pUnit, const SpellEntry* pSpell)
 {
-    for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_SPELLHIT]; idx < m_EventTypeOffset[EVENT_T_SPELLHIT + 1]; ++idx)
     {
-        if (i->Event.event_type == EVENT_T_SPELLHIT)
+        CreatureEventAIHolder& holder = m_CreatureEventAIList[m_EventIndexByType[idx]];
+
+        // If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.Event.spell_hit.spellId || pSpell->Id == holder.Event.spell_hit.spellId)
         {
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!i->Event.spell_hit.spellId || pSpell->Id == i->Event.spell_hit.spellId)
+            if (pSpell->SchoolMask & holder.Event.spell_hit.schoolMask)
             {
-                if (pSpell->SchoolMask & i->Event.spell_hit.schoolMask)
-                {
-                    ProcessEvent(*i, pUnit);
-                }
+                ProcessEvent(holder, pUnit);
             }
         }
     }
@@ -1831,6 +1874,12 @@ void CreatureEventAI::UpdateAI(const uint32 diff)
                 }
             }
 
+            // Decrement the delay of friendly searches without result
+            if (i->SearchDelay)
+            {
+                i->SearchDelay = i->SearchDelay > m_EventDiff ? i->SearchDelay - m_EventDiff : 0;
+            }
+
             // Skip processing of events that have time remaining or are disabled
             if (!(i->Enabled) || i->Time)
             {
@@ -2025,33 +2074,6 @@ Unit* CreatureEventAI::DoSelectLowestHpFriendly(float range, uint32 MinHPDiff)
     return pUnit;
 }
 
-/**
- * @brief Finds friendly crowd-controlled creatures in range.
- *
- * @param _list Receives matching creatures.
- * @param range The search radius.
- */
-void CreatureEventAI::DoFindFriendlyCC(std::list<Creature*>& _list, float range)
-{
-    MaNGOS::FriendlyCCedInRangeCheck u_check(m_creature, range);
-    MaNGOS::CreatureListSearcher<MaNGOS::FriendlyCCedInRangeCheck> searcher(_list, u_check);
-    Cell::VisitGridObjects(m_creature, searcher, range);
-}
-
-/**
- * @brief Finds friendly creatures missing a specific buff in range.
- *
- * @param _list Receives matching creatures.
- * @param range The search radius.
- * @param spellid The buff spell id.
- */
-void CreatureEventAI::DoFindFriendlyMissingBuff(std::list<Creature*>& _list, float range, uint32 spellid)
-{
-    MaNGOS::FriendlyMissingBuffInRangeCheck u_check(m_creature, range, spellid);
-    MaNGOS::CreatureListSearcher<MaNGOS::FriendlyMissingBuffInRangeCheck> searcher(_list, u_check);
-    Cell::VisitGridObjects(m_creature, searcher, range);
-}
-
 //*********************************
 //*** Functions used globally ***
 
@@ -2063,21 +2085,19 @@ void CreatureEventAI::DoFindFriendlyMissingBuff(std::list<Creature*>& _list, flo
  */
 void CreatureEventAI::ReceiveEmote(Player* pPlayer, uint32 text_emote)
 {
-    for (CreatureEventAIList::iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
+    for (uint16 idx = m_EventTypeOffset[EVENT_T_RECEIVE_EMOTE]; idx < m_EventTypeOffset[EVENT_T_RECEIVE_EMOTE + 1]; ++idx)
     {
-        if (itr->Event.event_type == EVENT_T_RECEIVE_EMOTE)
+        CreatureEventAIHolder& holder = m_CreatureEventAIList[m_EventIndexByType[idx]];
+        if (holder.Event.receive_emote.emoteId != text_emote)
         {
-            if (itr->Event.receive_emote.emoteId != text_emote)
-            {
-                continue;
-            }
+            continue;
+        }
 
-            PlayerCondition pcon(0, itr->Event.receive_emote.condition, itr->Event.receive_emote.conditionValue1, itr->Event.receive_emote.conditionValue2);
-            if (pcon.Meets(pPlayer, m_creature->GetMap(), m_creature, CONDITION_FROM_EVENTAI))
-            {
-                DEBUG_FILTER_LOG(LOG_FILTER_AI_AND_MOVEGENSS, "CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
-                ProcessEvent(*itr, pPlayer);
-            }
+        PlayerCondition pcon(0, holder.Event.receive_emote.condition, holder.Event.receive_emote.conditionValue1, holder.Event.receive_emote.conditionValue2);
+        if (pcon.Meets(pPlayer, m_creature->GetMap(), m_creature, CONDITION_FROM_EVENTAI))
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_AI_AND_MOVEGENSS, "CreatureEventAI: ReceiveEmote CreatureEventAI: Condition ok, processing");
+            ProcessEvent(holder, pPlayer);
         }
     }
 }
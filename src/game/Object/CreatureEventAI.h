@@ -34,6 +34,7 @@ class Player;
 class WorldObject;
 
 #define EVENT_UPDATE_TIME               500
+#define EVENT_FRIENDLY_SEARCH_DELAY     2000                // Retry delay of friendly grid searches that found nothing
 #define MAX_ACTIONS                     3
 #define MAX_PHASE                       32
 
@@ -633,10 +634,11 @@ typedef UNORDERED_MAP<uint32, CreatureEventAI_Summon> CreatureEventAI_Summon_Map
 
 struct CreatureEventAIHolder
 {
-    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), Enabled(true) {}
+    CreatureEventAIHolder(CreatureEventAI_Event p) : Event(p), Time(0), SearchDelay(0), Enabled(true) {}
 
     CreatureEventAI_Event Event;
     uint32 Time;
+    uint32 SearchDelay;                                     // Time until a friendly search without result may run again
     bool Enabled;
 
     // helper
@@ -686,8 +688,8 @@ class CreatureEventAI : public CreatureAI
         bool SpawnedEventConditionsCheck(CreatureEventAI_Event const& event);
 
         Unit* DoSelectLowestHpFriendly(float range, uint32 MinHPDiff);
-        void DoFindFriendlyMissingBuff(std::list<Creature*>& _list, float range, uint32 spellid);
-        void DoFindFriendlyCC(std::list<Creature*>& _list, float range);
+
+        void BuildEventTypeIndex();
 
     protected:
         uint32 m_EventUpdateTime;                           // Time between event updates
@@ -697,6 +699,10 @@ class CreatureEventAI : public CreatureAI
         typedef std::vector<CreatureEventAIHolder> CreatureEventAIList;
         CreatureEventAIList m_CreatureEventAIList;          // Holder for events (stores enabled, time, and eventid)
 
+        // Events partitioned by type, so event handlers only visit the events they can trigger
+        std::vector<uint16> m_EventIndexByType;             // Indexes into m_CreatureEventAIList, grouped by event type
+        uint16 m_EventTypeOffset[EVENT_T_END + 1];          // Events of type T are in [m_EventTypeOffset[T], m_EventTypeOffset[T + 1])
+
         uint8  m_Phase;                                     // Current phase, max 32 phases
         bool   m_MeleeEnabled;                              // If we allow melee auto attack
         bool   m_HasOOCLoSEvent;                            // Cache if a OOC-LoS Event exists
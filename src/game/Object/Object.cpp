@@ -309,6 +309,16 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) c
 
     BuildMovementUpdate(&buf, updateFlags);
 
+    // the create block carries the running spline, a deferred launch of it must not restart it
+    if (isType(TYPEMASK_UNIT) && (updateFlags & UPDATEFLAG_LIVING))
+    {
+        Unit const* unit = (Unit const*)this;
+        if (unit->IsInWorld() && (unit->m_movementInfo.GetMovementFlags() & MOVEFLAG_SPLINE_ENABLED))
+        {
+            unit->GetMap()->OnSplineSentInCreate(unit, target);
+        }
+    }
+
     UpdateMask updateMask;
     updateMask.SetCount(m_valuesCount);
     _SetCreateBits(&updateMask, target);
@@ -2498,6 +2508,28 @@ void WorldObject::SendMessageToSetExcept(WorldPacket* data, Player const* skippe
     }
 }
 
+/**
+ * @brief Broadcasts a packet that only shows something, like an emote.
+ *
+ * Players whose client falls behind (see WorldSession::IsSendCongested)
+ * do not get it. A player always gets its own.
+ *
+ * @param data The packet to send.
+ */
+void WorldObject::SendCosmeticMessageToSet(WorldPacket* data) const
+{
+    // if object is in world, map for it already created!
+    if (IsInWorld())
+    {
+        GetMap()->CosmeticMessageBroadcast(this, data);
+    }
+
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        ((Player const*)this)->GetSession()->SendPacket(data);
+    }
+}
+
 /**
  * @brief Assigns the current map context to the world object.
  *
@@ -763,6 +763,7 @@ class WorldObject : public Object
         virtual void SendMessageToSet(WorldPacket* data, bool self) const;
         virtual void SendMessageToSetInRange(WorldPacket* data, float dist, bool self) const;
         void SendMessageToSetExcept(WorldPacket* data, Player const* skipped_receiver) const;
+        void SendCosmeticMessageToSet(WorldPacket* data) const; // left out for clients with a send backlog
 
         void MonsterSay(const char* text, uint32 language, Unit const* target = NULL) const;
         void MonsterYell(const char* text, uint32 language, Unit const* target = NULL) const;
@@ -33,7 +33,7 @@
  * Key components:
  * - ThreatCalcHelper: Calculates threat values with modifiers
  * - HostileReference: Individual threat relationship between units
- * - ThreatContainer: Sorted list of threatening units
+ * - ThreatContainer: Sorted array of threatening units with per-reference index handles
  * - ThreatManager: Main threat management for a unit
  *
  * @see ThreatManager for the main manager class
@@ -113,6 +113,7 @@ HostileReference::HostileReference(Unit* pUnit, ThreatManager* pThreatManager, f
 {
     iThreat = pThreat;
     iTempThreatModifyer = 0.0f;
+    iThreatListIndex = uint32(-1);
     link(pUnit, pThreatManager);
     iUnitGuid = pUnit->GetObjectGuid();
     iOnline = true;
@@ -327,6 +328,43 @@ void ThreatContainer::clearReferences()
     iThreatList.clear();
 }
 
+/**
+ * @brief Add reference
+ * @param pHostileReference Reference to add
+ *
+ * Appends the reference and stores its position handle. The list is only
+ * brought back in order on the next update().
+ */
+void ThreatContainer::addReference(HostileReference* pHostileReference)
+{
+    pHostileReference->setThreatListIndex(iThreatList.size());
+    iThreatList.push_back(pHostileReference);
+}
+
+/**
+ * @brief Remove reference
+ * @param pRef Reference to remove
+ *
+ * Uses the position handle of the reference to find it, the relative
+ * order of the remaining references is kept.
+ */
+void ThreatContainer::remove(HostileReference* pRef)
+{
+    if (!contains(pRef))
+    {
+        return;
+    }
+
+    uint32 index = pRef->getThreatListIndex();
+    iThreatList.erase(iThreatList.begin() + index);
+    for (uint32 i = index; i < iThreatList.size(); ++i)
+    {
+        iThreatList[i]->setThreatListIndex(i);
+    }
+
+    pRef->setThreatListIndex(uint32(-1));
+}
+
 /**
  * @brief Get reference by target unit
  * @param pVictim Target unit to find
@@ -396,30 +434,36 @@ void ThreatContainer::modifyThreatPercent(Unit* pVictim, int32 pPercent)
 
 //============================================================
 
-/**
- * @brief Hostile reference sort predicate
- * @param lhs First reference
- * @param rhs Second reference
- * @return True if lhs has higher threat
- *
- * Sort predicate for ordering hostile references by threat (descending).
- */
-bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileReference* rhs)
-{
-    // std::list::sort ordering predicate must be: (Pred(x,y)&&Pred(y,x))==false
-    return lhs->getThreat() > rhs->getThreat();             // reverse sorting
-}
-
 /**
  * @brief Update threat container
  *
- * Sorts the threat list if it has been modified (dirty flag set).
+ * Brings the threat list back in order (descending threat) if it has been
+ * modified (dirty flag set).
+ *
+ * Between two updates usually only a few references change their threat, so
+ * the list is almost sorted. An insertion sort is linear for that case and
+ * keeps the position handles of the references up to date while moving them.
  */
 void ThreatContainer::update()
 {
     if (iDirty && iThreatList.size() > 1)
     {
-        iThreatList.sort(HostileReferenceSortPredicate);
+        for (uint32 i = 1; i < iThreatList.size(); ++i)
+        {
+            HostileReference* ref = iThreatList[i];
+            uint32 j = i;
+            for (; j > 0 && iThreatList[j - 1]->getThreat() < ref->getThreat(); --j)
+            {
+                iThreatList[j] = iThreatList[j - 1];
+                iThreatList[j]->setThreatListIndex(j);
+            }
+
+            if (j != i)
+            {
+                iThreatList[j] = ref;
+                ref->setThreatListIndex(j);
+            }
+        }
     }
     iDirty = false;
 }
@@ -441,6 +485,11 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
     bool onlySecondChoiceTargetsFound = false;
     bool checkedCurrentVictim = false;
 
+    if (iThreatList.empty())
+    {
+        return NULL;
+    }
+
     ThreatList::const_iterator lastRef = iThreatList.end();
     --lastRef;
 
@@ -684,6 +733,22 @@ Unit* ThreatManager::getHostileTarget()
 
 //============================================================
 
+/**
+ * @brief Get reference by threat rank
+ * @param pRank Position in the threat list, 0 is the most hated
+ * @return HostileReference or NULL if the list is shorter
+ *
+ * Updates the threat container so the rank reflects the current threat
+ * values and returns the reference at that position.
+ */
+HostileReference* ThreatManager::getReferenceByRank(uint32 pRank)
+{
+    iThreatContainer.update();
+    return iThreatContainer.getReferenceByRank(pRank);
+}
+
+//============================================================
+
 /**
  * @brief Get threat value for unit
  * @param pVictim Target unit
@@ -776,11 +841,9 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch (threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostileReference && threatRefStatusChangeEvent->getFValue() < 0.0f) ||
-                (getCurrentVictim() != hostileReference && threatRefStatusChangeEvent->getFValue() > 0.0f))
-            {
-                setDirty(true);                              // the order in the threat list might have changed
-            }
+            // the order in the threat list might have changed, re-ordering an almost sorted
+            // list is cheap and keeps rank lookups (getReferenceByRank) exact
+            setDirty(true);
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
             if (!hostileReference->isOnline())
@@ -795,12 +858,10 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
             }
             else
             {
-                if (getCurrentVictim() && hostileReference->getThreat() > (1.1f * getCurrentVictim()->getThreat()))
-                {
-                    setDirty(true);
-                }
-                iThreatContainer.addReference(hostileReference);
+                // remove first, the position handle is only valid for one container
                 iThreatOfflineContainer.remove(hostileReference);
+                iThreatContainer.addReference(hostileReference);
+                setDirty(true);                             // appended at the end, needs to be moved into place
             }
             break;
         case UEV_THREAT_REF_REMOVE_FROM_LIST:
@@ -30,7 +30,7 @@
 #include "Utilities/LinkedReference/Reference.h"
 #include "UnitEvents.h"
 #include "ObjectGuid.h"
-#include <list>
+#include <vector>
 
 //==============================================================
 
@@ -216,7 +216,25 @@ class HostileReference : public Reference<Unit, ThreatManager>
          */
         void sourceObjectDestroyLink() override;
 
+        /**
+         * @brief Get position in the owning threat container
+         *
+         * Maintained by ThreatContainer so a reference can be located without
+         * scanning the threat list.
+         *
+         * @return Index in the threat list
+         */
+        uint32 getThreatListIndex() const { return iThreatListIndex; }
+
     private:
+        friend class ThreatContainer;
+
+        /**
+         * @brief Set position in the owning threat container
+         * @param pIndex Index in the threat list
+         */
+        void setThreatListIndex(uint32 pIndex) { iThreatListIndex = pIndex; }
+
         /**
          * @brief Fire status changed event
          *
@@ -231,6 +249,7 @@ class HostileReference : public Reference<Unit, ThreatManager>
         float iThreat; ///< Current threat
         float iTempThreatModifyer; ///< Temporary threat modifier (used for taunt)
         ObjectGuid iUnitGuid; ///< Unit GUID
+        uint32 iThreatListIndex; ///< Position handle in the owning ThreatContainer
         bool iOnline; ///< Online status
         bool iAccessible; ///< Accessible status
 };
@@ -238,12 +257,14 @@ class HostileReference : public Reference<Unit, ThreatManager>
 //==============================================================
 class ThreatManager;
 
-typedef std::list<HostileReference*> ThreatList;
+typedef std::vector<HostileReference*> ThreatList;
 
 /**
  * @brief Threat container class
  *
  * Manages a list of hostile references and provides threat-related operations.
+ * The list is kept ordered by descending threat as an array; every reference
+ * stores its own index, so removal and rank lookups do not need a search.
  */
 class ThreatContainer
 {
@@ -258,13 +279,13 @@ class ThreatContainer
          * @brief Remove reference
          * @param pRef Reference to remove
          */
-        void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
+        void remove(HostileReference* pRef);
 
         /**
          * @brief Add reference
          * @param pHostileReference Reference to add
          */
-        void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+        void addReference(HostileReference* pHostileReference);
 
         /**
          * @brief Clear all references
@@ -278,6 +299,16 @@ class ThreatContainer
          */
         void update();
 
+        /**
+         * @brief Check if reference is stored in this container
+         * @param pRef Reference to check
+         * @return True if the reference's position handle points into this container
+         */
+        bool contains(HostileReference const* pRef) const
+        {
+            return pRef->getThreatListIndex() < iThreatList.size() && iThreatList[pRef->getThreatListIndex()] == pRef;
+        }
+
     public:
         /**
          * @brief Constructor
@@ -336,6 +367,16 @@ class ThreatContainer
          */
         HostileReference* getMostHated() { return iThreatList.empty() ? NULL : iThreatList.front(); }
 
+        /**
+         * @brief Get reference by threat rank
+         *
+         * Only meaningful after update(), rank 0 is the most hated reference.
+         *
+         * @param pRank Position in the threat list
+         * @return Hostile reference or NULL if the list is shorter
+         */
+        HostileReference* getReferenceByRank(uint32 pRank) { return pRank < iThreatList.size() ? iThreatList[pRank] : NULL; }
+
         /**
          * @brief Get reference by target
          * @param pVictim Victim unit
@@ -431,6 +472,17 @@ class ThreatManager
          */
         void processThreatEvent(ThreatRefStatusChangeEvent* threatRefStatusChangeEvent);
 
+        /**
+         * @brief Get reference by threat rank
+         *
+         * Brings the threat list in order first, so this is cheap to use from
+         * scripts that need the Nth highest entry.
+         *
+         * @param pRank Position in the threat list, 0 is the most hated
+         * @return Hostile reference or NULL if the list is shorter
+         */
+        HostileReference* getReferenceByRank(uint32 pRank);
+
         /**
          * @brief Get current victim
          * @return Current victim reference
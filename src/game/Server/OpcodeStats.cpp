@@ -0,0 +1,350 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file OpcodeStats.cpp
+ * @brief Per opcode handler time, traffic and rate limits
+ *
+ * Counters are kept per thread and summed on demand for the
+ * `.server opcodes` command and the OpcodeStatsFile dump.
+ */
+
+#include "OpcodeStats.h"
+#include "Opcodes.h"
+#include "Log.h"
+#include "Config/Config.h"
+#include "Util.h"
+#include "Policies/Singleton.h"
+
+#include <ace/Guard_T.h>
+
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(OpcodeStats);
+
+/**
+ * @brief Counters of one opcode in one thread
+ */
+struct OpcodeCounters
+{
+    std::atomic<uint64> calls;
+    std::atomic<uint64> time;
+    std::atomic<uint64> maxTime;
+    std::atomic<uint64> bytesIn;
+    std::atomic<uint64> sent;
+    std::atomic<uint64> bytesOut;
+    std::atomic<uint64> throttled;
+};
+
+/**
+ * @brief Counters of all opcodes in one thread
+ *
+ * Only the owning thread adds to them, so the atomic updates never contend.
+ * Other threads read them for reports and clear them on reset.
+ */
+struct OpcodeThreadCounters
+{
+    OpcodeThreadCounters()
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        {
+            OpcodeCounters& counters = opcodes[i];
+            counters.calls.store(0, std::memory_order_relaxed);
+            counters.time.store(0, std::memory_order_relaxed);
+            counters.maxTime.store(0, std::memory_order_relaxed);
+            counters.bytesIn.store(0, std::memory_order_relaxed);
+            counters.sent.store(0, std::memory_order_relaxed);
+            counters.bytesOut.store(0, std::memory_order_relaxed);
+            counters.throttled.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    OpcodeCounters opcodes[NUM_MSG_TYPES];
+};
+
+static thread_local OpcodeThreadCounters* t_opcodeCounters = NULL;
+
+/**
+ * @brief Look up an opcode by name or number
+ * @param text Opcode name, decimal or 0x prefixed hex number
+ * @return Opcode, NUM_MSG_TYPES if there is none
+ */
+static uint32 ParseOpcode(std::string const& text)
+{
+    if (!text.empty() && isdigit(text[0]))
+    {
+        uint32 opcode = uint32(strtoul(text.c_str(), NULL, 0));
+        return opcode < NUM_MSG_TYPES ? opcode : NUM_MSG_TYPES;
+    }
+
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        if (opcodeTable[opcode].name && text == opcodeTable[opcode].name)
+        {
+            return opcode;
+        }
+    }
+
+    return NUM_MSG_TYPES;
+}
+
+/**
+ * @brief Constructor, recording is on and no limits are set
+ */
+OpcodeStats::OpcodeStats() : m_enabled(true), m_rateLimits(NUM_MSG_TYPES, 0), m_rateLimitWindow(10000), m_resetTime(getMSTime())
+{
+}
+
+OpcodeStats::~OpcodeStats()
+{
+    for (std::vector<OpcodeThreadCounters*>::const_iterator itr = m_threads.begin(); itr != m_threads.end(); ++itr)
+    {
+        delete *itr;
+    }
+}
+
+/**
+ * @brief Read the configuration, called again on config reload
+ */
+void OpcodeStats::Initialize()
+{
+    m_enabled = sConfig.GetBoolDefault("OpcodeStats", true);
+
+    m_dumpFile = sConfig.GetStringDefault("OpcodeStatsFile", "");
+    if (!m_dumpFile.empty())
+    {
+        std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
+        if (!logsDir.empty() && logsDir[logsDir.length() - 1] != '/' && logsDir[logsDir.length() - 1] != '\\')
+        {
+            logsDir.append("/");
+        }
+
+        m_dumpFile = logsDir + m_dumpFile;
+    }
+
+    m_dumpTimer.SetInterval(std::max(sConfig.GetIntDefault("OpcodeStatsInterval", 60), 1) * IN_MILLISECONDS);
+    m_dumpTimer.SetCurrent(0);
+
+    m_rateLimitWindow = std::max(sConfig.GetIntDefault("OpcodeRateLimitWindow", 10000), 100);
+
+    std::fill(m_rateLimits.begin(), m_rateLimits.end(), 0);
+    Tokens limits = StrSplit(sConfig.GetStringDefault("OpcodeRateLimits", ""), ",");
+    for (Tokens::const_iterator itr = limits.begin(); itr != limits.end(); ++itr)
+    {
+        std::string::size_type separator = itr->find(':');
+        uint32 opcode = ParseOpcode(itr->substr(0, separator));
+        if (separator == std::string::npos || opcode >= NUM_MSG_TYPES)
+        {
+            sLog.outError("OpcodeRateLimits: %s is not an opcode:limit pair, ignored", itr->c_str());
+            continue;
+        }
+
+        m_rateLimits[opcode] = uint32(strtoul(itr->c_str() + separator + 1, NULL, 10));
+    }
+}
+
+/**
+ * @brief Write the dump file when its interval passed
+ * @param diff Time since the last call in milliseconds
+ */
+void OpcodeStats::Update(uint32 diff)
+{
+    if (m_dumpFile.empty() || !m_enabled)
+    {
+        return;
+    }
+
+    m_dumpTimer.Update(diff);
+    if (!m_dumpTimer.Passed())
+    {
+        return;
+    }
+
+    m_dumpTimer.Reset();
+    if (!WriteDump(m_dumpFile))
+    {
+        sLog.outError("OpcodeStats: can not write %s", m_dumpFile.c_str());
+    }
+}
+
+/**
+ * @brief Get the counters of the calling thread
+ * @param opcode Opcode to count
+ * @return Counters of the opcode
+ */
+OpcodeCounters& OpcodeStats::GetCounters(uint16 opcode)
+{
+    if (!t_opcodeCounters)
+    {
+        t_opcodeCounters = new OpcodeThreadCounters();
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, t_opcodeCounters->opcodes[opcode]);
+        m_threads.push_back(t_opcodeCounters);
+    }
+
+    return t_opcodeCounters->opcodes[opcode];
+}
+
+/**
+ * @brief Count a handled packet
+ * @param opcode Opcode of the packet
+ * @param bytes Payload size
+ * @param micros Handler time in microseconds
+ */
+void OpcodeStats::RecordHandled(uint16 opcode, size_t bytes, uint64 micros)
+{
+    OpcodeCounters& counters = GetCounters(opcode);
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.time.fetch_add(micros, std::memory_order_relaxed);
+    counters.bytesIn.fetch_add(bytes, std::memory_order_relaxed);
+
+    if (micros > counters.maxTime.load(std::memory_order_relaxed))
+    {
+        counters.maxTime.store(micros, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Count a sent packet
+ * @param opcode Opcode of the packet
+ * @param bytes Payload size
+ */
+void OpcodeStats::RecordSent(uint16 opcode, size_t bytes)
+{
+    OpcodeCounters& counters = GetCounters(opcode);
+    counters.sent.fetch_add(1, std::memory_order_relaxed);
+    counters.bytesOut.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count a packet dropped by the rate limit
+ * @param opcode Opcode of the packet
+ */
+void OpcodeStats::RecordThrottled(uint16 opcode)
+{
+    GetCounters(opcode).throttled.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sum the counters of all threads
+ * @param entries Receives the opcodes that were handled, sent or throttled
+ */
+void OpcodeStats::Collect(std::vector<OpcodeStatsEntry>& entries)
+{
+    std::vector<OpcodeStatsEntry> totals(NUM_MSG_TYPES);
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        memset(&totals[i], 0, sizeof(OpcodeStatsEntry));
+        totals[i].opcode = uint16(i);
+    }
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+        for (std::vector<OpcodeThreadCounters*>::const_iterator itr = m_threads.begin(); itr != m_threads.end(); ++itr)
+        {
+            for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+            {
+                OpcodeCounters const& counters = (*itr)->opcodes[i];
+                OpcodeStatsEntry& total = totals[i];
+                total.calls += counters.calls.load(std::memory_order_relaxed);
+                total.time += counters.time.load(std::memory_order_relaxed);
+                total.maxTime = std::max(total.maxTime, counters.maxTime.load(std::memory_order_relaxed));
+                total.bytesIn += counters.bytesIn.load(std::memory_order_relaxed);
+                total.sent += counters.sent.load(std::memory_order_relaxed);
+                total.bytesOut += counters.bytesOut.load(std::memory_order_relaxed);
+                total.throttled += counters.throttled.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    entries.clear();
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        if (totals[i].calls || totals[i].sent || totals[i].throttled)
+        {
+            entries.push_back(totals[i]);
+        }
+    }
+}
+
+/**
+ * @brief Clear the counters of all threads
+ *
+ * A packet counted by another thread at the same time may be partly kept.
+ */
+void OpcodeStats::Reset()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    for (std::vector<OpcodeThreadCounters*>::const_iterator itr = m_threads.begin(); itr != m_threads.end(); ++itr)
+    {
+        (*itr)->Clear();
+    }
+
+    m_resetTime = getMSTime();
+}
+
+/**
+ * @brief Write the current totals as CSV
+ *
+ * The file is written under a temporary name and renamed, so readers never
+ * see a partial dump.
+ *
+ * @param fileName File to write, replaced if it exists
+ * @return True if the file could be written
+ */
+bool OpcodeStats::WriteDump(std::string const& fileName)
+{
+    std::vector<OpcodeStatsEntry> entries;
+    Collect(entries);
+
+    std::string tempName = fileName + ".tmp";
+    FILE* file = fopen(tempName.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+
+    fprintf(file, "opcode,name,calls,time_us,max_time_us,bytes_in,sent,bytes_out,throttled,elapsed_ms\n");
+    uint32 elapsed = GetElapsed();
+    for (std::vector<OpcodeStatsEntry>::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        fprintf(file, "%u,%s," UI64FMTD "," UI64FMTD "," UI64FMTD "," UI64FMTD "," UI64FMTD "," UI64FMTD "," UI64FMTD ",%u\n",
+                itr->opcode, LookupOpcodeName(itr->opcode), itr->calls, itr->time, itr->maxTime,
+                itr->bytesIn, itr->sent, itr->bytesOut, itr->throttled, elapsed);
+    }
+
+    bool written = !ferror(file);
+    fclose(file);
+
+    // rename does not replace an existing file everywhere
+    remove(fileName.c_str());
+    return written && rename(tempName.c_str(), fileName.c_str()) == 0;
+}
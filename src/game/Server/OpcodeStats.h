@@ -0,0 +1,167 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_OPCODESTATS
+#define MANGOS_H_OPCODESTATS
+
+#include "Common.h"
+#include "Timer.h"
+#include "Policies/Singleton.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <string>
+#include <vector>
+
+struct OpcodeCounters;
+struct OpcodeThreadCounters;
+
+/**
+ * @brief Totals of one opcode, summed over all threads
+ */
+struct OpcodeStatsEntry
+{
+    uint16 opcode;
+    uint64 calls;                                           ///< handled packets
+    uint64 time;                                            ///< total handler time in microseconds
+    uint64 maxTime;                                         ///< longest handler call in microseconds
+    uint64 bytesIn;                                         ///< payload of handled packets
+    uint64 sent;                                            ///< sent packets
+    uint64 bytesOut;                                        ///< payload of sent packets
+    uint64 throttled;                                       ///< packets dropped by the rate limit
+};
+
+/**
+ * @brief Per opcode handler time, traffic and rate limits
+ *
+ * Every thread that handles or sends world packets counts into its own
+ * block of counters, so recording never contends with other threads. The
+ * blocks are only summed when a report is asked for, by the
+ * `.server opcodes` command or the periodic dump file. The dump is a CSV
+ * file rewritten every OpcodeStatsInterval seconds.
+ *
+ * Rate limits cap how often a session may send an opcode within the
+ * OpcodeRateLimitWindow, packets over the limit are dropped unhandled.
+ */
+class OpcodeStats
+{
+    public:
+        OpcodeStats();
+        ~OpcodeStats();
+
+        /**
+         * @brief Read the configuration, called again on config reload
+         */
+        void Initialize();
+
+        /**
+         * @brief Write the dump file when its interval passed
+         * @param diff Time since the last call in milliseconds
+         */
+        void Update(uint32 diff);
+
+        /**
+         * @brief Check if counters are recorded
+         * @return True if enabled
+         */
+        bool IsEnabled() const { return m_enabled; }
+
+        /**
+         * @brief Count a handled packet
+         * @param opcode Opcode of the packet
+         * @param bytes Payload size
+         * @param micros Handler time in microseconds
+         */
+        void RecordHandled(uint16 opcode, size_t bytes, uint64 micros);
+
+        /**
+         * @brief Count a sent packet
+         * @param opcode Opcode of the packet
+         * @param bytes Payload size
+         */
+        void RecordSent(uint16 opcode, size_t bytes);
+
+        /**
+         * @brief Count a packet dropped by the rate limit
+         * @param opcode Opcode of the packet
+         */
+        void RecordThrottled(uint16 opcode);
+
+        /**
+         * @brief Get the rate limit of an opcode
+         * @param opcode Opcode to check
+         * @return Packets allowed per session within the window, 0 for no limit
+         */
+        uint32 GetRateLimit(uint16 opcode) const { return opcode < m_rateLimits.size() ? m_rateLimits[opcode] : 0; }
+
+        /**
+         * @brief Get the rate limit window
+         * @return Window length in milliseconds
+         */
+        uint32 GetRateLimitWindow() const { return m_rateLimitWindow; }
+
+        /**
+         * @brief Sum the counters of all threads
+         * @param entries Receives the opcodes that were handled, sent or throttled
+         */
+        void Collect(std::vector<OpcodeStatsEntry>& entries);
+
+        /**
+         * @brief Get time since the counters were reset
+         * @return Elapsed time in milliseconds
+         */
+        uint32 GetElapsed() const { return GetMSTimeDiffToNow(m_resetTime); }
+
+        /**
+         * @brief Clear the counters of all threads
+         */
+        void Reset();
+
+        /**
+         * @brief Write the current totals as CSV
+         * @param fileName File to write, replaced if it exists
+         * @return True if the file could be written
+         */
+        bool WriteDump(std::string const& fileName);
+
+    private:
+        OpcodeStats(OpcodeStats const&);
+        OpcodeStats& operator=(OpcodeStats const&);
+
+        OpcodeCounters& GetCounters(uint16 opcode);
+
+        bool m_enabled;
+        std::vector<uint32> m_rateLimits;                   ///< packets per window by opcode, 0 for none
+        uint32 m_rateLimitWindow;
+        std::string m_dumpFile;
+        IntervalTimer m_dumpTimer;
+        uint32 m_resetTime;                                 ///< getMSTime() of last reset
+
+        ACE_Thread_Mutex m_lock;                            ///< guards the list of thread blocks
+        std::vector<OpcodeThreadCounters*> m_threads;       ///< blocks stay when their thread ends
+};
+
+#define sOpcodeStats MaNGOS::Singleton<OpcodeStats>::Instance()
+
+#endif
@@ -163,29 +163,29 @@ void InitializeOpcodes()
     OPCODE(SMSG_LOGOUT_COMPLETE,                           STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_LOGOUT_CANCEL,                             STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleLogoutCancelOpcode);
     OPCODE(SMSG_LOGOUT_CANCEL_ACK,                         STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_NAME_QUERY,                                STATUS_AUTHED,   PROCESS_THREADUNSAFE, &WorldSession::HandleNameQueryOpcode);
+    OPCODE(CMSG_NAME_QUERY,                                STATUS_AUTHED,   PROCESS_SESSIONSAFE,  &WorldSession::HandleNameQueryOpcode);
     OPCODE(SMSG_NAME_QUERY_RESPONSE,                       STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_PET_NAME_QUERY,                            STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandlePetNameQueryOpcode);
     OPCODE(SMSG_PET_NAME_QUERY_RESPONSE,                   STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_GUILD_QUERY,                               STATUS_AUTHED,   PROCESS_THREADUNSAFE, &WorldSession::HandleGuildQueryOpcode);
+    OPCODE(CMSG_GUILD_QUERY,                               STATUS_AUTHED,   PROCESS_SESSIONSAFE,  &WorldSession::HandleGuildQueryOpcode);
     OPCODE(SMSG_GUILD_QUERY_RESPONSE,                      STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_ITEM_QUERY_SINGLE,                         STATUS_LOGGEDIN, PROCESS_INPLACE,      &WorldSession::HandleItemQuerySingleOpcode);
     OPCODE(CMSG_ITEM_QUERY_MULTIPLE,                       STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     OPCODE(SMSG_ITEM_QUERY_SINGLE_RESPONSE,                STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_ITEM_QUERY_MULTIPLE_RESPONSE,              STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_PAGE_TEXT_QUERY,                           STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandlePageTextQueryOpcode);
+    OPCODE(CMSG_PAGE_TEXT_QUERY,                           STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandlePageTextQueryOpcode);
     OPCODE(SMSG_PAGE_TEXT_QUERY_RESPONSE,                  STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_QUEST_QUERY,                               STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleQuestQueryOpcode);
+    OPCODE(CMSG_QUEST_QUERY,                               STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleQuestQueryOpcode);
     OPCODE(SMSG_QUEST_QUERY_RESPONSE,                      STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_GAMEOBJECT_QUERY,                          STATUS_LOGGEDIN, PROCESS_INPLACE,      &WorldSession::HandleGameObjectQueryOpcode);
     OPCODE(SMSG_GAMEOBJECT_QUERY_RESPONSE,                 STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_CREATURE_QUERY,                            STATUS_LOGGEDIN, PROCESS_INPLACE,      &WorldSession::HandleCreatureQueryOpcode);
     OPCODE(SMSG_CREATURE_QUERY_RESPONSE,                   STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_WHO,                                       STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleWhoOpcode);
+    OPCODE(CMSG_WHO,                                       STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleWhoOpcode);
     OPCODE(SMSG_WHO,                                       STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_WHOIS,                                     STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleWhoisOpcode);
     OPCODE(SMSG_WHOIS,                                     STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_CONTACT_LIST,                              STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleContactListOpcode);
+    OPCODE(CMSG_CONTACT_LIST,                              STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleContactListOpcode);
     OPCODE(SMSG_CONTACT_LIST,                              STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_FRIEND_STATUS,                             STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_ADD_FRIEND,                                STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleAddFriendOpcode);
@@ -220,7 +220,7 @@ void InitializeOpcodes()
     OPCODE(SMSG_GUILD_DECLINE,                             STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_GUILD_INFO,                                STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleGuildInfoOpcode);
     OPCODE(SMSG_GUILD_INFO,                                STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_GUILD_ROSTER,                              STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleGuildRosterOpcode);
+    OPCODE(CMSG_GUILD_ROSTER,                              STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleGuildRosterOpcode);
     OPCODE(SMSG_GUILD_ROSTER,                              STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_GUILD_PROMOTE,                             STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleGuildPromoteOpcode);
     OPCODE(CMSG_GUILD_DEMOTE,                              STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleGuildDemoteOpcode);
@@ -337,9 +337,9 @@ void InitializeOpcodes()
     OPCODE(CMSG_NEXT_CINEMATIC_CAMERA,                     STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleNextCinematicCamera);
     OPCODE(CMSG_COMPLETE_CINEMATIC,                        STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleCompleteCinematic);
     OPCODE(SMSG_TUTORIAL_FLAGS,                            STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_TUTORIAL_FLAG,                             STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleTutorialFlagOpcode);
-    OPCODE(CMSG_TUTORIAL_CLEAR,                            STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleTutorialClearOpcode);
-    OPCODE(CMSG_TUTORIAL_RESET,                            STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleTutorialResetOpcode);
+    OPCODE(CMSG_TUTORIAL_FLAG,                             STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleTutorialFlagOpcode);
+    OPCODE(CMSG_TUTORIAL_CLEAR,                            STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleTutorialClearOpcode);
+    OPCODE(CMSG_TUTORIAL_RESET,                            STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleTutorialResetOpcode);
     OPCODE(CMSG_STANDSTATECHANGE,                          STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleStandStateChangeOpcode);
     OPCODE(CMSG_EMOTE,                                     STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleEmoteOpcode);
     OPCODE(SMSG_EMOTE,                                     STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -379,7 +379,7 @@ void InitializeOpcodes()
     OPCODE(CMSG_SET_FACTION_ATWAR,                         STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleSetFactionAtWarOpcode);
     OPCODE(CMSG_SET_FACTION_CHEAT,                         STATUS_NEVER,    PROCESS_THREADUNSAFE, &WorldSession::Handle_Deprecated);
     OPCODE(SMSG_SET_PROFICIENCY,                           STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_SET_ACTION_BUTTON,                         STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleSetActionButtonOpcode);
+    OPCODE(CMSG_SET_ACTION_BUTTON,                         STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleSetActionButtonOpcode);
     OPCODE(SMSG_ACTION_BUTTONS,                            STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_INITIAL_SPELLS,                            STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_LEARNED_SPELL,                             STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -605,14 +605,14 @@ void InitializeOpcodes()
     OPCODE(CMSG_GMTICKET_UPDATETEXT,                       STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleGMTicketUpdateTextOpcode);
     OPCODE(SMSG_GMTICKET_UPDATETEXT,                       STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_ACCOUNT_DATA_TIMES,                        STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_REQUEST_ACCOUNT_DATA,                      STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleRequestAccountData);
-    OPCODE(CMSG_UPDATE_ACCOUNT_DATA,                       STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT, PROCESS_THREADUNSAFE, &WorldSession::HandleUpdateAccountData);
+    OPCODE(CMSG_REQUEST_ACCOUNT_DATA,                      STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleRequestAccountData);
+    OPCODE(CMSG_UPDATE_ACCOUNT_DATA,                       STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT, PROCESS_SESSIONSAFE,  &WorldSession::HandleUpdateAccountData);
     OPCODE(SMSG_UPDATE_ACCOUNT_DATA,                       STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_CLEAR_FAR_SIGHT_IMMEDIATE,                 STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_POWERGAINLOG_OBSOLETE,                     STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_GM_TEACH,                                  STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     OPCODE(CMSG_GM_CREATE_ITEM_TARGET,                     STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
-    OPCODE(CMSG_GMTICKET_GETTICKET,                        STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleGMTicketGetTicketOpcode);
+    OPCODE(CMSG_GMTICKET_GETTICKET,                        STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleGMTicketGetTicketOpcode);
     OPCODE(SMSG_GMTICKET_GETTICKET,                        STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_UNLEARN_TALENTS,                           STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     OPCODE(SMSG_GAMEOBJECT_SPAWN_ANIM_OBSOLETE,            STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -662,7 +662,7 @@ void InitializeOpcodes()
     OPCODE(SMSG_BATTLEFIELD_LOSE_OBSOLETE,                 STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_TAXICLEARNODE,                             STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     OPCODE(CMSG_TAXIENABLENODE,                            STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
-    OPCODE(CMSG_ITEM_TEXT_QUERY,                           STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleItemTextQuery);
+    OPCODE(CMSG_ITEM_TEXT_QUERY,                           STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleItemTextQuery);
     OPCODE(SMSG_ITEM_TEXT_QUERY_RESPONSE,                  STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_MAIL_TAKE_MONEY,                           STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleMailTakeMoney);
     OPCODE(CMSG_MAIL_TAKE_ITEM,                            STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleMailTakeItem);
@@ -727,7 +727,7 @@ void InitializeOpcodes()
     OPCODE(CMSG_RESET_FACTION_CHEAT,                       STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     OPCODE(CMSG_AUTOSTORE_BANK_ITEM,                       STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleAutoStoreBankItemOpcode);
     OPCODE(CMSG_AUTOBANK_ITEM,                             STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleAutoBankItemOpcode);
-    OPCODE(MSG_QUERY_NEXT_MAIL_TIME,                       STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleQueryNextMailTime);
+    OPCODE(MSG_QUERY_NEXT_MAIL_TIME,                       STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleQueryNextMailTime);
     OPCODE(SMSG_RECEIVED_MAIL,                             STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_RAID_GROUP_ONLY,                           STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_SET_DURABILITY_CHEAT,                      STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
@@ -791,7 +791,7 @@ void InitializeOpcodes()
     OPCODE(MSG_PETITION_RENAME,                            STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandlePetitionRenameOpcode);
     OPCODE(SMSG_INIT_WORLD_STATES,                         STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_UPDATE_WORLD_STATE,                        STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_ITEM_NAME_QUERY,                           STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleItemNameQueryOpcode);
+    OPCODE(CMSG_ITEM_NAME_QUERY,                           STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleItemNameQueryOpcode);
     OPCODE(SMSG_ITEM_NAME_QUERY_RESPONSE,                  STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_PET_ACTION_FEEDBACK,                       STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_CHAR_RENAME,                               STATUS_AUTHED,   PROCESS_THREADUNSAFE, &WorldSession::HandleCharRenameOpcode);
@@ -800,7 +800,7 @@ void InitializeOpcodes()
     OPCODE(CMSG_MOVE_FALL_RESET,                           STATUS_LOGGEDIN, PROCESS_THREADSAFE,   &WorldSession::HandleMovementOpcodes);
     OPCODE(SMSG_INSTANCE_SAVE_CREATED,                     STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_RAID_INSTANCE_INFO,                        STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_REQUEST_RAID_INFO,                         STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleRequestRaidInfoOpcode);
+    OPCODE(CMSG_REQUEST_RAID_INFO,                         STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleRequestRaidInfoOpcode);
     OPCODE(CMSG_MOVE_TIME_SKIPPED,                         STATUS_LOGGEDIN, PROCESS_INPLACE,      &WorldSession::HandleMoveTimeSkippedOpcode);
     OPCODE(CMSG_MOVE_FEATHER_FALL_ACK,                     STATUS_LOGGEDIN, PROCESS_THREADSAFE,   &WorldSession::HandleFeatherFallAck);
     OPCODE(CMSG_MOVE_WATER_WALK_ACK,                       STATUS_LOGGEDIN, PROCESS_THREADSAFE,   &WorldSession::HandleMoveWaterWalkAck);
@@ -826,7 +826,7 @@ void InitializeOpcodes()
     OPCODE(SMSG_AREA_SPIRIT_HEALER_TIME,                   STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_GM_UNTEACH,                                STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     OPCODE(SMSG_WARDEN_DATA,                               STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_WARDEN_DATA,                               STATUS_AUTHED,   PROCESS_THREADUNSAFE, &WorldSession::HandleWardenDataOpcode);
+    OPCODE(CMSG_WARDEN_DATA,                               STATUS_AUTHED,   PROCESS_SESSIONSAFE,  &WorldSession::HandleWardenDataOpcode);
     OPCODE(SMSG_GROUP_JOINED_BATTLEGROUND,                 STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(MSG_BATTLEGROUND_PLAYER_POSITIONS,              STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleBattleGroundPlayerPositionsOpcode);
     OPCODE(CMSG_PET_STOP_ATTACK,                           STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandlePetStopAttack);
@@ -926,9 +926,9 @@ void InitializeOpcodes()
     OPCODE(CMSG_ARENA_TEAM_CREATE,                         STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
     OPCODE(SMSG_ARENA_TEAM_COMMAND_RESULT,                 STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(UMSG_UPDATE_ARENA_TEAM_OBSOLETE,                STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_NULL);
-    OPCODE(CMSG_ARENA_TEAM_QUERY,                          STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleArenaTeamQueryOpcode);
+    OPCODE(CMSG_ARENA_TEAM_QUERY,                          STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleArenaTeamQueryOpcode);
     OPCODE(SMSG_ARENA_TEAM_QUERY_RESPONSE,                 STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_ARENA_TEAM_ROSTER,                         STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleArenaTeamRosterOpcode);
+    OPCODE(CMSG_ARENA_TEAM_ROSTER,                         STATUS_LOGGEDIN, PROCESS_SESSIONSAFE,  &WorldSession::HandleArenaTeamRosterOpcode);
     OPCODE(SMSG_ARENA_TEAM_ROSTER,                         STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(CMSG_ARENA_TEAM_INVITE,                         STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandleArenaTeamInviteOpcode);
     OPCODE(SMSG_ARENA_TEAM_INVITE,                         STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
@@ -991,7 +991,7 @@ void InitializeOpcodes()
     OPCODE(CMSG_SET_TAXI_BENCHMARK_MODE,                   STATUS_AUTHED,   PROCESS_THREADUNSAFE, &WorldSession::HandleSetTaxiBenchmarkOpcode);
     OPCODE(SMSG_JOINED_BATTLEGROUND_QUEUE,                 STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
     OPCODE(SMSG_REALM_SPLIT,                               STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
-    OPCODE(CMSG_REALM_SPLIT,                               STATUS_AUTHED,   PROCESS_THREADUNSAFE, &WorldSession::HandleRealmSplitOpcode);
+    OPCODE(CMSG_REALM_SPLIT,                               STATUS_AUTHED,   PROCESS_SESSIONSAFE,  &WorldSession::HandleRealmSplitOpcode);
     OPCODE(CMSG_MOVE_CHNG_TRANSPORT,                       STATUS_LOGGEDIN, PROCESS_THREADSAFE,   &WorldSession::HandleMovementOpcodes);
     OPCODE(MSG_PARTY_ASSIGNMENT,                           STATUS_LOGGEDIN, PROCESS_THREADUNSAFE, &WorldSession::HandlePartyAssignmentOpcode);
     OPCODE(SMSG_OFFER_PETITION_ERROR,                      STATUS_NEVER,    PROCESS_INPLACE,      &WorldSession::Handle_ServerSide);
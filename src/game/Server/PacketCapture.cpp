@@ -0,0 +1,259 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file PacketCapture.cpp
+ * @brief Binary world packet capture with sampling
+ *
+ * Replaces the hex text dump of WorldLogFile for loaded realms: packets are
+ * written as binary records by a background writer, and only the sampled
+ * accounts, opcodes or a fraction of all packets are captured.
+ */
+
+#include "PacketCapture.h"
+#include "Opcodes.h"
+#include "Log.h"
+#include "LogWriter.h"
+#include "Config/Config.h"
+#include "Util.h"
+#include "Policies/Singleton.h"
+
+#include <chrono>
+
+INSTANTIATE_SINGLETON_1(PacketCapture);
+
+#define PACKET_CAPTURE_RECORD_HEADER    24                  // size field included
+
+/**
+ * @brief Store a value little endian
+ * @param dest Destination
+ * @param value Value to store
+ * @param bytes Number of bytes to store
+ */
+static inline void PutLittleEndian(uint8* dest, uint64 value, uint32 bytes)
+{
+    for (uint32 i = 0; i < bytes; ++i)
+    {
+        dest[i] = uint8(value >> (i * 8));
+    }
+}
+
+/**
+ * @brief Constructor, capturing is off
+ */
+PacketCapture::PacketCapture() : m_enabled(false), m_file(NULL), m_writer(NULL), m_writerThread(NULL),
+    m_sampleRate(1), m_bufferSize(1024 * 1024), m_sequence(0), m_captured(0)
+{
+}
+
+PacketCapture::~PacketCapture()
+{
+    Stop();
+}
+
+/**
+ * @brief Read the filters and start capturing if a file is configured
+ */
+void PacketCapture::Initialize()
+{
+    m_accounts.clear();
+    Tokens accounts = StrSplit(sConfig.GetStringDefault("PacketCaptureAccounts", ""), ",");
+    for (Tokens::const_iterator itr = accounts.begin(); itr != accounts.end(); ++itr)
+    {
+        if (uint32 account = uint32(strtoul(itr->c_str(), NULL, 10)))
+        {
+            m_accounts.insert(account);
+        }
+    }
+
+    m_opcodes.clear();
+    Tokens opcodes = StrSplit(sConfig.GetStringDefault("PacketCaptureOpcodes", ""), ",");
+    for (Tokens::const_iterator itr = opcodes.begin(); itr != opcodes.end(); ++itr)
+    {
+        uint32 opcode = uint32(strtoul(itr->c_str(), NULL, 0));
+        if (opcode >= NUM_MSG_TYPES)
+        {
+            sLog.outError("PacketCaptureOpcodes: opcode %s does not exist, ignored", itr->c_str());
+            continue;
+        }
+
+        m_opcodes.resize(NUM_MSG_TYPES, false);
+        m_opcodes[opcode] = true;
+    }
+
+    m_sampleRate = std::max(sConfig.GetIntDefault("PacketCaptureSampleRate", 1), 1);
+    m_bufferSize = std::max(sConfig.GetIntDefault("PacketCaptureBufferSize", 1024), 64) * 1024;
+
+    std::string fileName = sConfig.GetStringDefault("PacketCaptureFile", "");
+    if (fileName.empty())
+    {
+        return;
+    }
+
+    std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
+    if (!logsDir.empty() && logsDir[logsDir.length() - 1] != '/' && logsDir[logsDir.length() - 1] != '\\')
+    {
+        logsDir.append("/");
+    }
+
+    if (!Start(logsDir + fileName))
+    {
+        sLog.outError("PacketCapture: can not open %s%s for writing", logsDir.c_str(), fileName.c_str());
+    }
+}
+
+/**
+ * @brief Start capturing into a file
+ * @param fileName File to write, truncated if it exists
+ * @return True if the file could be opened
+ */
+bool PacketCapture::Start(std::string const& fileName)
+{
+    Stop();
+
+    ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, false)
+
+    m_file = fopen(fileName.c_str(), "wb");
+    if (!m_file)
+    {
+        return false;
+    }
+
+    uint8 header[8];
+    PutLittleEndian(header, PACKET_CAPTURE_MAGIC, 4);
+    PutLittleEndian(header + 4, PACKET_CAPTURE_VERSION, 4);
+    fwrite(header, sizeof(header), 1, m_file);
+
+    // captured packets are dropped rather than stalling the network and map threads
+    m_writer = new LogWriter(m_bufferSize, true, NULL);
+    m_writerThread = new ACE_Based::Thread(m_writer);     // owns m_writer
+
+    m_captured.store(0, std::memory_order_relaxed);
+    m_enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Stop capturing, queued packets are written first
+ * @return Number of packets written
+ */
+uint64 PacketCapture::Stop()
+{
+    m_enabled.store(false, std::memory_order_relaxed);
+
+    ACE_WRITE_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, m_lock, 0)
+
+    uint64 dropped = 0;
+    if (m_writerThread)
+    {
+        dropped = m_writer->GetDropped();
+        if (dropped)
+        {
+            sLog.outString("PacketCapture: " UI64FMTD " packets dropped, consider a larger PacketCaptureBufferSize", dropped);
+        }
+
+        m_writer->Stop();
+        m_writerThread->wait();
+        delete m_writerThread;                              // This also deletes m_writer
+        m_writerThread = NULL;
+        m_writer = NULL;
+    }
+
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = NULL;
+    }
+
+    return m_captured.load(std::memory_order_relaxed) - dropped;
+}
+
+/**
+ * @brief Get number of packets dropped because the buffer was full
+ * @return Dropped packet count
+ */
+uint64 PacketCapture::GetDropped() const
+{
+    ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, const_cast<ACE_RW_Thread_Mutex&>(m_lock), 0)
+    return m_writer ? m_writer->GetDropped() : 0;
+}
+
+/**
+ * @brief Check a packet against the account, opcode and rate filters
+ * @param account Account id of the socket
+ * @param opcode Packet opcode
+ * @return True if the packet is captured
+ */
+bool PacketCapture::IsSampled(uint32 account, uint16 opcode)
+{
+    if (!m_accounts.empty() && m_accounts.find(account) == m_accounts.end())
+    {
+        return false;
+    }
+
+    if (!m_opcodes.empty() && (opcode >= m_opcodes.size() || !m_opcodes[opcode]))
+    {
+        return false;
+    }
+
+    return m_sampleRate <= 1 || m_sequence.fetch_add(1, std::memory_order_relaxed) % m_sampleRate == 0;
+}
+
+/**
+ * @brief Capture a packet if it passes the filters
+ *
+ * Called from network and map threads. The filters are only changed
+ * while the write lock is held, so they are read without copies.
+ *
+ * @param socket Socket handle
+ * @param account Account id of the socket, 0 if not authenticated
+ * @param opcode Packet opcode
+ * @param packet Packet data
+ * @param direction Packet direction
+ */
+void PacketCapture::Capture(uint32 socket, uint32 account, uint16 opcode, ByteBuffer const& packet, PacketCaptureDirection direction)
+{
+    ACE_READ_GUARD(ACE_RW_Thread_Mutex, guard, m_lock)
+
+    if (!m_writer || !IsSampled(account, opcode))
+    {
+        return;
+    }
+
+    uint64 now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    uint8 header[PACKET_CAPTURE_RECORD_HEADER];
+    PutLittleEndian(header, PACKET_CAPTURE_RECORD_HEADER - 4 + packet.size(), 4);
+    PutLittleEndian(header + 4, now, 8);
+    PutLittleEndian(header + 12, socket, 4);
+    PutLittleEndian(header + 16, account, 4);
+    PutLittleEndian(header + 20, opcode, 2);
+    header[22] = uint8(direction);
+    header[23] = 0;
+
+    if (m_writer->WriteRaw(m_file, header, sizeof(header), packet.size() ? packet.contents() : NULL, packet.size()))
+    {
+        m_captured.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,146 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_PACKETCAPTURE
+#define MANGOS_H_PACKETCAPTURE
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <ace/RW_Thread_Mutex.h>
+
+#include <set>
+#include <vector>
+
+class ByteBuffer;
+class LogWriter;
+
+#define PACKET_CAPTURE_MAGIC        0x544B504D              // 'MPKT'
+#define PACKET_CAPTURE_VERSION      1
+
+/**
+ * @brief Direction of a captured packet
+ */
+enum PacketCaptureDirection
+{
+    PACKET_CAPTURE_CLIENT_TO_SERVER = 0,
+    PACKET_CAPTURE_SERVER_TO_CLIENT = 1
+};
+
+/**
+ * @brief Binary world packet capture
+ *
+ * Writes world packets as length prefixed binary records through its own
+ * background writer, so capturing costs the calling thread a copy of the
+ * packet into a ring buffer instead of formatted text I/O. A record is
+ *
+ *     uint32 size                 bytes following this field
+ *     uint64 time                 ms since epoch
+ *     uint32 socket
+ *     uint32 account              0 before authentication
+ *     uint16 opcode
+ *     uint8  direction            PacketCaptureDirection
+ *     uint8  reserved
+ *     uint8  data[size - 20]
+ *
+ * after a file header of the magic and the version, all little endian.
+ * Packets can be sampled by account, by opcode and by rate. The files are
+ * converted to text or pcap by contrib/packetCapture/PacketCaptureConvert.py.
+ */
+class PacketCapture
+{
+    public:
+        PacketCapture();
+        ~PacketCapture();
+
+        /**
+         * @brief Start capturing with the configured file and filters
+         */
+        void Initialize();
+
+        /**
+         * @brief Start capturing into a file
+         * @param fileName File to write, truncated if it exists
+         * @return True if the file could be opened
+         */
+        bool Start(std::string const& fileName);
+
+        /**
+         * @brief Stop capturing, queued packets are written first
+         * @return Number of packets written
+         */
+        uint64 Stop();
+
+        /**
+         * @brief Check if packets are captured
+         * @return True if capturing
+         */
+        bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Capture a packet if it passes the filters
+         * @param socket Socket handle
+         * @param account Account id of the socket, 0 if not authenticated
+         * @param opcode Packet opcode
+         * @param packet Packet data
+         * @param direction Packet direction
+         */
+        void Capture(uint32 socket, uint32 account, uint16 opcode, ByteBuffer const& packet, PacketCaptureDirection direction);
+
+        /**
+         * @brief Get number of captured packets since start
+         * @return Captured packet count
+         */
+        uint64 GetCaptured() const { return m_captured.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get number of packets dropped because the buffer was full
+         * @return Dropped packet count
+         */
+        uint64 GetDropped() const;
+
+    private:
+        PacketCapture(PacketCapture const&);
+        PacketCapture& operator=(PacketCapture const&);
+
+        bool IsSampled(uint32 account, uint16 opcode);
+
+        std::atomic<bool> m_enabled;                        ///< checked before taking the lock
+        ACE_RW_Thread_Mutex m_lock;                         ///< write locked while starting or stopping
+        FILE* m_file;
+        LogWriter* m_writer;
+        ACE_Based::Thread* m_writerThread;
+
+        std::set<uint32> m_accounts;                        ///< empty for all accounts
+        std::vector<bool> m_opcodes;                        ///< empty for all opcodes
+        uint32 m_sampleRate;                                ///< capture one of this many packets
+        uint32 m_bufferSize;                                ///< ring size per thread in bytes
+
+        std::atomic<uint32> m_sequence;
+        std::atomic<uint64> m_captured;
+};
+
+#define sPacketCapture MaNGOS::Singleton<PacketCapture>::Instance()
+
+#endif
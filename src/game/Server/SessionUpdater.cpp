@@ -0,0 +1,187 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+/**
+ * @file SessionUpdater.cpp
+ * @brief Implementation of the SessionUpdater class.
+ */
+
+#include "SessionUpdater.h"
+#include "WorldSession.h"
+#include "Log.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+#include <algorithm>
+
+/// Fewest sessions handed to one thread, smaller batches cost more in scheduling than they save
+#define SESSION_UPDATE_MIN_BATCH 32
+
+/**
+ * @brief A request to handle the session safe packets of a batch of sessions.
+ */
+class SessionUpdateRequest : public ACE_Method_Request
+{
+    private:
+        WorldSession* const* m_sessions; ///< First session of the batch.
+        size_t m_count; ///< Number of sessions in the batch.
+        SessionUpdater& m_updater; ///< Reference to the session updater.
+
+    public:
+        /**
+         * @brief Constructor for SessionUpdateRequest.
+         * @param sessions First session of the batch.
+         * @param count Number of sessions in the batch.
+         * @param u Reference to the session updater.
+         */
+        SessionUpdateRequest(WorldSession* const* sessions, size_t count, SessionUpdater& u)
+            : m_sessions(sessions), m_count(count), m_updater(u)
+        {
+        }
+
+        /**
+         * @brief Executes the session update request.
+         * @return Always returns 0.
+         */
+        virtual int call()
+        {
+            for (size_t i = 0; i < m_count; ++i)
+            {
+                SessionSafeFilter filter(m_sessions[i]);
+                m_sessions[i]->ProcessPackets(filter);
+                m_sessions[i]->UpdateWarden();
+            }
+
+            m_updater.update_finished();
+            return 0;
+        }
+};
+
+/**
+ * @brief Constructor for SessionUpdater.
+ */
+SessionUpdater::SessionUpdater() :
+    m_executor(), m_mutex(), m_condition(m_mutex), m_pendingRequests(0), m_threads(0)
+{
+}
+
+/**
+ * @brief Destructor for SessionUpdater.
+ */
+SessionUpdater::~SessionUpdater()
+{
+    deactivate();
+}
+
+/**
+ * @brief Activates the session updater with the specified number of threads.
+ * @param num_threads Number of threads to activate.
+ * @return Result of the activation.
+ */
+int SessionUpdater::activate(size_t num_threads)
+{
+    m_threads = num_threads;
+    return m_executor._activate((int)num_threads);
+}
+
+/**
+ * @brief Deactivates the session updater.
+ * @return Result of the deactivation.
+ */
+int SessionUpdater::deactivate()
+{
+    if (!m_executor.activated())
+    {
+        return -1;
+    }
+
+    return m_executor.deactivate();
+}
+
+/**
+ * @brief Checks if the session updater is activated.
+ * @return True if activated, false otherwise.
+ */
+bool SessionUpdater::activated()
+{
+    return m_executor.activated();
+}
+
+/**
+ * @brief Handles the session safe packets of the sessions and waits until all are done.
+ *
+ * The sessions are split into about four batches per thread, so a thread
+ * that drew sessions with many packets does not hold up the others.
+ *
+ * @param sessions Sessions to handle, none of them may be updated elsewhere meanwhile.
+ */
+void SessionUpdater::Update(std::vector<WorldSession*> const& sessions)
+{
+    if (sessions.empty())
+    {
+        return;
+    }
+
+    size_t batch = std::max<size_t>(SESSION_UPDATE_MIN_BATCH, sessions.size() / (m_threads * 4) + 1);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    for (size_t first = 0; first < sessions.size(); first += batch)
+    {
+        size_t count = std::min(batch, sessions.size() - first);
+
+        ++m_pendingRequests;
+        if (m_executor.execute(new SessionUpdateRequest(&sessions[first], count, *this)) == -1)
+        {
+            sLog.outError("SessionUpdater::Update: Failed to schedule a session update, handling it in place");
+            --m_pendingRequests;
+
+            for (size_t i = first; i < first + count; ++i)
+            {
+                SessionSafeFilter filter(sessions[i]);
+                sessions[i]->ProcessPackets(filter);
+                sessions[i]->UpdateWarden();
+            }
+        }
+    }
+
+    while (m_pendingRequests > 0)
+    {
+        m_condition.wait();
+    }
+}
+
+/**
+ * @brief Called when an update request is finished.
+ */
+void SessionUpdater::update_finished()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    --m_pendingRequests;
+
+    m_condition.broadcast();
+}
@@ -0,0 +1,103 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+/**
+ * @file SessionUpdater.h
+ * @brief Parallel processing of session safe packets.
+ *
+ * Packets whose handlers only touch their own session (PROCESS_SESSIONSAFE)
+ * are handled for many sessions at once on a pool of threads, before
+ * World::UpdateSessions handles the remaining packets one session at a time.
+ */
+
+#ifndef MANGOS_H_SESSIONUPDATER
+#define MANGOS_H_SESSIONUPDATER
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include "DelayExecutor.h"
+
+#include <vector>
+
+class WorldSession;
+
+/**
+ * @brief The SessionUpdater class handles the session safe packets of all sessions.
+ */
+class SessionUpdater
+{
+    public:
+        /**
+         * @brief Constructor for SessionUpdater.
+         */
+        SessionUpdater();
+
+        /**
+         * @brief Destructor for SessionUpdater.
+         */
+        virtual ~SessionUpdater();
+
+        friend class SessionUpdateRequest;
+
+        /**
+         * @brief Handles the session safe packets of the sessions and waits until all are done.
+         * @param sessions Sessions to handle, none of them may be updated elsewhere meanwhile.
+         */
+        void Update(std::vector<WorldSession*> const& sessions);
+
+        /**
+         * @brief Activates the session updater with the specified number of threads.
+         * @param num_threads Number of threads to activate.
+         * @return Result of the activation.
+         */
+        int activate(size_t num_threads);
+
+        /**
+         * @brief Deactivates the session updater.
+         * @return Result of the deactivation.
+         */
+        int deactivate();
+
+        /**
+         * @brief Checks if the session updater is activated.
+         * @return True if activated, false otherwise.
+         */
+        bool activated();
+
+    private:
+        DelayExecutor m_executor; ///< Executor running the update requests.
+        ACE_Thread_Mutex m_mutex; ///< Mutex for synchronizing access to pending requests.
+        ACE_Condition_Thread_Mutex m_condition; ///< Condition variable for signaling when requests are processed.
+        size_t m_pendingRequests; ///< Number of pending update requests.
+        size_t m_threads; ///< Number of activated threads.
+
+        /**
+         * @brief Called when an update request is finished.
+         */
+        void update_finished();
+};
+
+#endif
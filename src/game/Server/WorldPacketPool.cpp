@@ -0,0 +1,164 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "WorldPacketPool.h"
+#include "WorldPacket.h"
+#include "Policies/Singleton.h"
+
+#include <ace/Guard_T.h>
+
+INSTANTIATE_SINGLETON_1(WorldPacketPool);
+
+#define PACKET_POOL_BATCH           64                      // packets moved between a thread and the depot at once
+#define PACKET_POOL_DEPOT_MAX       8192                    // packets kept in the depot, more are freed
+#define PACKET_POOL_MAX_CAPACITY    2048                    // larger buffers are freed, not kept
+
+/**
+ * @brief Packets kept by one thread
+ *
+ * Freed when the thread ends instead of returned to the depot, the pool
+ * may already be gone at process exit.
+ */
+struct WorldPacketStock
+{
+    ~WorldPacketStock()
+    {
+        for (std::vector<WorldPacket*>::const_iterator itr = packets.begin(); itr != packets.end(); ++itr)
+        {
+            delete *itr;
+        }
+    }
+
+    std::vector<WorldPacket*> packets;
+};
+
+static thread_local WorldPacketStock t_packetStock;
+
+WorldPacketPool::WorldPacketPool() : m_depotSize(0), m_acquired(0), m_recycled(0)
+{
+}
+
+WorldPacketPool::~WorldPacketPool()
+{
+    for (std::vector<WorldPacket*>::const_iterator itr = m_depot.begin(); itr != m_depot.end(); ++itr)
+    {
+        delete *itr;
+    }
+}
+
+/**
+ * @brief Get an empty packet
+ * @param opcode Opcode of the packet
+ * @param size Buffer size to reserve
+ * @return Packet, owned by the caller until given to Release or deleted
+ */
+WorldPacket* WorldPacketPool::Acquire(uint16 opcode, size_t size)
+{
+    m_acquired.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<WorldPacket*>& stock = t_packetStock.packets;
+    if (stock.empty() && m_depotSize.load(std::memory_order_relaxed))
+    {
+        Fill(stock);
+    }
+
+    if (stock.empty())
+    {
+        return new WorldPacket(opcode, size);
+    }
+
+    WorldPacket* packet = stock.back();
+    stock.pop_back();
+    packet->Initialize(opcode, size);
+
+    m_recycled.fetch_add(1, std::memory_order_relaxed);
+    return packet;
+}
+
+/**
+ * @brief Give a packet back to the pool
+ * @param packet Packet from Acquire or allocated with new
+ */
+void WorldPacketPool::Release(WorldPacket* packet)
+{
+    if (packet->capacity() > PACKET_POOL_MAX_CAPACITY)
+    {
+        delete packet;
+        return;
+    }
+
+    std::vector<WorldPacket*>& stock = t_packetStock.packets;
+    stock.push_back(packet);
+
+    if (stock.size() >= 2 * PACKET_POOL_BATCH)
+    {
+        Spill(stock);
+    }
+}
+
+/**
+ * @brief Move a batch from the depot to a thread's stock
+ * @param stock Stock of the calling thread
+ */
+void WorldPacketPool::Fill(std::vector<WorldPacket*>& stock)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    size_t count = std::min<size_t>(PACKET_POOL_BATCH, m_depot.size());
+    stock.insert(stock.end(), m_depot.end() - count, m_depot.end());
+    m_depot.resize(m_depot.size() - count);
+    m_depotSize.store(uint32(m_depot.size()), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Move a batch from a thread's stock to the depot
+ *
+ * Packets the depot has no room for are freed.
+ *
+ * @param stock Stock of the calling thread
+ */
+void WorldPacketPool::Spill(std::vector<WorldPacket*>& stock)
+{
+    size_t count = std::min<size_t>(PACKET_POOL_BATCH, stock.size());
+    std::vector<WorldPacket*>::iterator first = stock.end() - count;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+        while (first != stock.end() && m_depot.size() < PACKET_POOL_DEPOT_MAX)
+        {
+            m_depot.push_back(*first);
+            ++first;
+        }
+
+        m_depotSize.store(uint32(m_depot.size()), std::memory_order_relaxed);
+    }
+
+    for (std::vector<WorldPacket*>::iterator itr = first; itr != stock.end(); ++itr)
+    {
+        delete *itr;
+    }
+
+    stock.resize(stock.size() - count);
+}
@@ -0,0 +1,111 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_WORLDPACKETPOOL
+#define MANGOS_H_WORLDPACKETPOOL
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <vector>
+
+class WorldPacket;
+
+/**
+ * @brief Recycles received world packets
+ *
+ * Network threads take packets for incoming messages from the pool and the
+ * threads handling them give them back, so a packet and its buffer are
+ * reused instead of allocated and freed for every message. Each thread keeps
+ * a small private stock and trades whole batches with a shared depot, so
+ * the depot lock is taken about once per batch. Packets that grew large
+ * buffers are freed instead of kept.
+ */
+class WorldPacketPool
+{
+    public:
+        WorldPacketPool();
+        ~WorldPacketPool();
+
+        /**
+         * @brief Get an empty packet
+         * @param opcode Opcode of the packet
+         * @param size Buffer size to reserve
+         * @return Packet, owned by the caller until given to Release or deleted
+         */
+        WorldPacket* Acquire(uint16 opcode, size_t size);
+
+        /**
+         * @brief Give a packet back to the pool
+         * @param packet Packet from Acquire or allocated with new
+         */
+        void Release(WorldPacket* packet);
+
+        /**
+         * @brief Get number of packets handed out
+         * @return Acquire call count
+         */
+        uint64 GetAcquired() const { return m_acquired.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get number of packets handed out that were recycled
+         * @return Recycled packet count
+         */
+        uint64 GetRecycled() const { return m_recycled.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get number of packets in the shared depot
+         * @return Depot size
+         */
+        uint32 GetDepotSize() const { return m_depotSize.load(std::memory_order_relaxed); }
+
+    private:
+        WorldPacketPool(WorldPacketPool const&);
+        WorldPacketPool& operator=(WorldPacketPool const&);
+
+        /**
+         * @brief Move a batch from the depot to a thread's stock
+         * @param stock Stock of the calling thread
+         */
+        void Fill(std::vector<WorldPacket*>& stock);
+
+        /**
+         * @brief Move a batch from a thread's stock to the depot
+         * @param stock Stock of the calling thread
+         */
+        void Spill(std::vector<WorldPacket*>& stock);
+
+        ACE_Thread_Mutex m_lock;                            ///< guards m_depot
+        std::vector<WorldPacket*> m_depot;
+        std::atomic<uint32> m_depotSize;
+
+        std::atomic<uint64> m_acquired;
+        std::atomic<uint64> m_recycled;
+};
+
+#define sWorldPacketPool MaNGOS::Singleton<WorldPacketPool>::Instance()
+
+#endif
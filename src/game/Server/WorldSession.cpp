@@ -50,7 +50,9 @@
 #include "Database/DatabaseEnv.h"
 #include "Log.h"
 #include "Opcodes.h"
+#include "OpcodeStats.h"
 #include "WorldPacket.h"
+#include "WorldPacketPool.h"
 #include "WorldSession.h"
 #include "Player.h"
 #include "ObjectMgr.h"
@@ -143,13 +145,36 @@ bool WorldSessionFilter::Process(WorldPacket* packet)
     return !MapSessionFilterHelper(m_pSession, opHandle);
 }
 
+/**
+ * @brief Process packet on a session update thread
+ * @param packet Packet to process
+ * @return True if packet should be processed
+ *
+ * Filters packets for processing in parallel with other sessions.
+ * Only session safe packets are processed, the rest is left in the
+ * queue for World::UpdateSessions and Map::Update in receive order.
+ */
+bool SessionSafeFilter::Process(WorldPacket* packet)
+{
+#ifdef ENABLE_PLAYERBOTS
+    // the bots of a master see its packets, which is not session safe
+    if (m_pSession->GetPlayer() && m_pSession->GetPlayer()->GetPlayerbotMgr())
+    {
+        return false;
+    }
+#endif
+
+    return opcodeTable[packet->GetOpcode()].packetProcessing == PROCESS_SESSIONSAFE;
+}
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8 expansion, time_t mute_time, LocaleConstant locale) :
     LookingForGroup_auto_join(false), LookingForGroup_auto_add(false), m_muteTime(mute_time),
-    _player(NULL), m_Socket(sock), _security(sec), _accountId(id), _warden(NULL), _build(0), m_expansion(expansion), _logoutTime(0),
+    _player(NULL), m_Socket(sock), _security(sec), _accountId(id), _warden(NULL), _build(0), m_wardenUpdated(false), m_expansion(expansion), _logoutTime(0),
     m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_npcWatchLastGuid()
+    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_npcWatchLastGuid(),
+    _recvQueueSize(0), _recvMaxAge(0)
 {
     if (sock)
     {
@@ -158,6 +183,40 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8
     }
 }
 
+/**
+ * @brief Advances Warden on a session update thread.
+ *
+ * Builds and sends the next check request there, so the world thread only
+ * applies the penalties. WorldSession::Update() skips its own Warden update
+ * for this tick afterwards.
+ */
+void WorldSession::UpdateWarden()
+{
+    if (m_Socket && !m_Socket->IsClosed() && _warden)
+    {
+        _warden->Update();
+        m_wardenUpdated = true;
+    }
+}
+
+/**
+ * @brief Check whether the session is worth handing to the session update threads.
+ *
+ * Sessions without received packets and without a Warden check request due
+ * are left to the world thread, which advances their Warden timers itself.
+ *
+ * @return True if packets are queued or a Warden request is due
+ */
+bool WorldSession::HasParallelWork() const
+{
+    if (GetRecvQueueSize() > 0)
+    {
+        return true;
+    }
+
+    return m_Socket && !m_Socket->IsClosed() && _warden && _warden->IsRequestDue();
+}
+
 /// WorldSession destructor
 WorldSession::~WorldSession()
 {
@@ -183,7 +242,7 @@ WorldSession::~WorldSession()
 
     ///- empty incoming packet queue
     WorldPacket* packet = NULL;
-    while (_recvQueue.next(packet))
+    while (NextPacket(packet, NULL))
     {
         delete packet;
     }
@@ -271,16 +330,100 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 
 #endif                                                  // !MANGOS_DEBUG
 
+    if (sOpcodeStats.IsEnabled())
+    {
+        sOpcodeStats.RecordSent(packet->GetOpcode(), packet->size());
+    }
+
     if (m_Socket->SendPacket(*packet) == -1)
     {
         m_Socket->CloseSocket();
     }
 }
 
+/// Bytes waiting in the socket buffers for a slow client
+uint32 WorldSession::GetSendBacklog() const
+{
+    return m_Socket ? uint32(m_Socket->GetOutPending()) : 0;
+}
+
+/// Packets waiting in the socket queue for a slow client
+uint32 WorldSession::GetSendQueuedPackets() const
+{
+    return m_Socket ? m_Socket->GetOutQueued() : 0;
+}
+
+/// Bytes sent to the client so far
+uint64 WorldSession::GetSentBytes() const
+{
+    return m_Socket ? m_Socket->GetOutSent() : 0;
+}
+
+/**
+ * @brief Checks whether the client falls behind the data sent to it.
+ *
+ * Callers leave out packets the client can do without (emotes, heartbeats
+ * of far players) while this holds, so a slow client does not pile up
+ * memory on the server.
+ *
+ * @return true if more than Network.SendBudget bytes wait to be sent.
+ */
+bool WorldSession::IsSendCongested() const
+{
+    uint32 budget = sWorld.getConfig(CONFIG_UINT32_SEND_BUDGET);
+    return budget && GetSendBacklog() > budget;
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
-    _recvQueue.add(new_packet);
+    QueuedPacket queued = { new_packet, getMSTime() };
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, _recvLock);
+    _recvIncoming.push_back(queued);
+    _recvQueueSize.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Take the next received packet if the filter accepts it
+ *
+ * When the handling side is empty it takes over everything received so
+ * far in one go, so the lock shared with the network thread is taken once
+ * per batch.
+ *
+ * @param packet Set to the packet, owned by the caller
+ * @param filter Filter of the calling update context, NULL to take any packet
+ * @return True if a packet was taken
+ */
+bool WorldSession::NextPacket(WorldPacket*& packet, PacketFilter* filter)
+{
+    if (_recvQueue.empty())
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, _recvLock, false);
+        _recvQueue.swap(_recvIncoming);
+    }
+
+    if (_recvQueue.empty())
+    {
+        return false;
+    }
+
+    QueuedPacket const& queued = _recvQueue.front();
+    if (filter && !filter->Process(queued.packet))
+    {
+        return false;
+    }
+
+    uint32 age = getMSTimeDiff(queued.queuedTime, getMSTime());
+    if (age > _recvMaxAge.load(std::memory_order_relaxed))
+    {
+        _recvMaxAge.store(age, std::memory_order_relaxed);
+    }
+
+    packet = queued.packet;
+    _recvQueue.pop_front();
+    _recvQueueSize.fetch_sub(1, std::memory_order_relaxed);
+    return true;
 }
 
 /// Logging helper for unexpected opcodes
@@ -301,13 +444,20 @@ void WorldSession::LogUnprocessedTail(WorldPacket* packet)
                   packet->rpos(), packet->wpos());
 }
 
-/// Update the WorldSession (triggered by World update)
-bool WorldSession::Update(PacketFilter& updater)
+/**
+ * @brief Handle the queued packets the filter accepts
+ *
+ * Packets are handled in receive order, the first packet the filter
+ * rejects stops the loop and is left for a later update.
+ *
+ * @param updater Filter of the calling update context
+ */
+void WorldSession::ProcessPackets(PacketFilter& updater)
 {
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
     WorldPacket* packet = NULL;
-    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, updater))
+    while (m_Socket && !m_Socket->IsClosed() && NextPacket(packet, &updater))
     {
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
@@ -421,8 +571,14 @@ bool WorldSession::Update(PacketFilter& updater)
             }
         }
 
-        delete packet;
+        sWorldPacketPool.Release(packet);
     }
+}
+
+/// Update the WorldSession (triggered by World update)
+bool WorldSession::Update(PacketFilter& updater)
+{
+    ProcessPackets(updater);
 
 #ifdef ENABLE_PLAYERBOTS
     if (GetPlayer() && GetPlayer()->GetPlayerbotMgr())
@@ -438,16 +594,27 @@ bool WorldSession::Update(PacketFilter& updater)
         m_Socket = NULL;
     }
 
-    // Warden
+    // Warden, unless the session update threads already did it this tick
     if (m_Socket && !m_Socket->IsClosed() && _warden)
     {
-        _warden->Update();
+        if (!m_wardenUpdated)
+        {
+            _warden->Update();
+        }
+
+        m_wardenUpdated = false;
     }
 
     // check if we are safe to proceed with logout
     // logout procedure should happen only in World::UpdateSessions() method!!!
     if (updater.ProcessLogout())
     {
+        ///- Punish the Warden failures found by the session update threads
+        if (_warden)
+        {
+            _warden->ApplyPenalty();
+        }
+
         ///- If necessary, log the player out
         time_t currTime = time(NULL);
         if (!m_Socket || (ShouldLogOut(currTime) && !m_playerLoading))
@@ -478,7 +645,7 @@ bool WorldSession::Update(PacketFilter& updater)
 void WorldSession::HandleBotPackets()
 {
     WorldPacket* packet;
-    while (_recvQueue.next(packet))
+    while (NextPacket(packet, NULL))
     {
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
         (this->*opHandle.handler)(*packet);
@@ -1012,6 +1179,11 @@ void WorldSession::SendTransferAborted(uint32 mapid, uint8 reason, uint8 arg)
  */
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet)
 {
+    if (IsOpcodeRateLimited(packet->GetOpcode()))
+    {
+        return;
+    }
+
 #ifdef ENABLE_ELUNA
     if (Eluna* e = sWorld.GetEluna())
     {
@@ -1029,7 +1201,17 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
         _player->SetCanDelayTeleport(true);
     }
 
-    (this->*opHandle.handler)(*packet);
+    if (sOpcodeStats.IsEnabled())
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        (this->*opHandle.handler)(*packet);
+        sOpcodeStats.RecordHandled(packet->GetOpcode(), packet->size(),
+                                   std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    else
+    {
+        (this->*opHandle.handler)(*packet);
+    }
 
     if (_player)
     {
@@ -1050,6 +1232,48 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
     }
 }
 
+/**
+ * @brief Checks an incoming opcode against its configured rate limit.
+ *
+ * Counts the packets of each rate limited opcode within a fixed window per
+ * session. Packets over the limit are dropped without calling the handler.
+ *
+ * @param opcode The received opcode.
+ * @return true if the packet must be dropped.
+ */
+bool WorldSession::IsOpcodeRateLimited(uint16 opcode)
+{
+    uint32 limit = sOpcodeStats.GetRateLimit(opcode);
+    if (!limit)
+    {
+        return false;
+    }
+
+    uint32 now = getMSTime();
+    OpcodeRateMap::iterator itr = m_opcodeRates.find(opcode);
+    if (itr == m_opcodeRates.end() || getMSTimeDiff(itr->second.windowStart, now) >= sOpcodeStats.GetRateLimitWindow())
+    {
+        OpcodeRate& rate = m_opcodeRates[opcode];
+        rate.windowStart = now;
+        rate.count = 1;
+        return false;
+    }
+
+    if (++itr->second.count <= limit)
+    {
+        return false;
+    }
+
+    if (itr->second.count == limit + 1)
+    {
+        DETAIL_LOG("SESSION: account %u sent %s more than %u times in %u ms, dropping it until the window ends",
+                   GetAccountId(), LookupOpcodeName(opcode), limit, sOpcodeStats.GetRateLimitWindow());
+    }
+
+    sOpcodeStats.RecordThrottled(opcode);
+    return true;
+}
+
 /**
  * @brief Sends a spell visual kit to be played on a target object.
  *
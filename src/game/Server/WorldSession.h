@@ -231,6 +231,48 @@ class WorldSessionFilter : public PacketFilter
         bool Process(WorldPacket* packet) override;
 };
 
+/**
+ * @brief Session safe packet filter class
+ *
+ * Class used to filter only packets that change nothing but their own
+ * session and player. Other players, guilds and arena teams may be read,
+ * nothing changes them while the session update threads of
+ * World::UpdateSessions() run.
+ */
+class SessionSafeFilter : public PacketFilter
+{
+    public:
+        /**
+         * @brief Constructor
+         * @param pSession World session
+         */
+        explicit SessionSafeFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+
+        /**
+         * @brief Destructor
+         */
+        ~SessionSafeFilter() {}
+
+        /**
+         * @brief Process packet
+         * @param packet World packet to process
+         * @return True if processed successfully
+         */
+        bool Process(WorldPacket* packet) override;
+
+        /**
+         * @brief Process logout
+         *
+         * Logout touches the world, it is never processed in parallel.
+         *
+         * @return False (logout not processed)
+         */
+        bool ProcessLogout() const override
+        {
+            return false;
+        }
+};
+
 /**
  * @brief World session class
  *
@@ -367,8 +409,38 @@ class WorldSession
 
         void QueuePacket(WorldPacket* new_packet);
 
+        /// Number of received packets not handled yet
+        uint32 GetRecvQueueSize() const { return _recvQueueSize.load(std::memory_order_relaxed); }
+
+        /// Longest time in ms a handled packet waited in the queue, optionally restarting the measure
+        uint32 GetRecvMaxAge(bool reset = false)
+        {
+            return reset ? _recvMaxAge.exchange(0, std::memory_order_relaxed) : _recvMaxAge.load(std::memory_order_relaxed);
+        }
+
+        /// Bytes sent to the socket and not yet handed to the kernel
+        uint32 GetSendBacklog() const;
+
+        /// Packets queued in the socket because its output buffer was full
+        uint32 GetSendQueuedPackets() const;
+
+        /// Bytes handed to the kernel since the connection opened
+        uint64 GetSentBytes() const;
+
+        /// Is the send backlog above Network.SendBudget? Low priority packets are then left out
+        bool IsSendCongested() const;
+
         bool Update(PacketFilter& updater);
 
+        /// Handle the queued packets the filter accepts, stopping at the first it rejects
+        void ProcessPackets(PacketFilter& updater);
+
+        /// Advance Warden from the session update threads
+        void UpdateWarden();
+
+        /// Whether the session update threads have anything to do for this session
+        bool HasParallelWork() const;
+
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
 
@@ -942,6 +1014,7 @@ class WorldSession
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet);
+        bool IsOpcodeRateLimited(uint16 opcode);
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* reason);
@@ -958,6 +1031,7 @@ class WorldSession
         // Warden
         Warden* _warden;                                    // Remains NULL if Warden system is not enabled by config
         uint16 _build;                                      // connected client build
+        bool m_wardenUpdated;                               // Warden already updated by the session update threads this tick
 
         time_t _logoutTime;
         bool m_inQueue;                                     // session wait in auth.queue
@@ -972,7 +1046,37 @@ class WorldSession
         TutorialDataState m_tutorialState;
         int32 m_clientTimeDelay;
         ObjectGuid m_npcWatchLastGuid;
-        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+
+        /// Packets of a rate limited opcode in the current window
+        struct OpcodeRate
+        {
+            uint32 windowStart;                             // getMSTime() when the window started
+            uint32 count;
+        };
+
+        typedef std::map<uint16, OpcodeRate> OpcodeRateMap;
+        OpcodeRateMap m_opcodeRates;                        // only opcodes with a rate limit
+
+        /// Received packet waiting to be handled
+        struct QueuedPacket
+        {
+            WorldPacket* packet;
+            uint32 queuedTime;                              // getMSTime() when queued
+        };
+
+        typedef std::deque<QueuedPacket> RecvQueue;
+
+        bool NextPacket(WorldPacket*& packet, PacketFilter* filter);
+
+        // Producers append to _recvIncoming under _recvLock. The handling
+        // thread takes the whole list over once _recvQueue is empty, so it
+        // locks once per batch instead of once per packet. Only one thread
+        // handles a session's packets at a time.
+        ACE_Thread_Mutex _recvLock;
+        RecvQueue _recvIncoming;
+        RecvQueue _recvQueue;
+        std::atomic<uint32> _recvQueueSize;                 // packets in both queues
+        std::atomic<uint32> _recvMaxAge;                    // longest wait of a handled packet in ms, since last reset
 };
 #endif
 /// @}
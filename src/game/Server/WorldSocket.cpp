@@ -71,6 +71,8 @@
 #include "WorldSocketMgr.h"
 #include "Log.h"
 #include "DBCStores.h"
+#include "PacketCapture.h"
+#include "WorldPacketPool.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -124,12 +126,17 @@ WorldSocket::WorldSocket(void) :
     m_LastPingTime(ACE_Time_Value::zero),
     m_OverSpeedPings(0),
     m_Session(0),
+    m_AccountId(0),
     m_RecvWPct(0),
     m_RecvPct(),
     m_Header(sizeof(ClientPktHeader)),
     m_OutBufferLock(),
     m_OutBuffer(0),
     m_OutBufferSize(65536),
+    m_OutActive(false),
+    m_OutPending(0),
+    m_OutQueued(0),
+    m_OutSent(0),
     m_Seed(static_cast<uint32>(rand32()))
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
@@ -158,6 +165,8 @@ WorldSocket::~WorldSocket(void)
     {
         delete pct;
     }
+
+    m_OutQueued.store(0, std::memory_order_relaxed);
 }
 
 /**
@@ -229,11 +238,21 @@ int WorldSocket::SendPacket(const WorldPacket& pkt)
             sLog.outError("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
             return -1;
         }
+
+        m_OutQueued.fetch_add(1, std::memory_order_relaxed);
     }
 
+    iEncryptHeaders();
+
+    m_OutPending.fetch_add(pct.size() + sizeof(ServerPktHeader), std::memory_order_relaxed);
+
+    // the reactor is told once until the output is drained, not for every packet
+    bool wakeup = !m_OutActive;
+    m_OutActive = true;
+
     Guard.release();
 
-    if (reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
+    if (wakeup && reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
     {
         sLog.outError("SendPacket failed setting WRITE mask, peer = %s", GetRemoteAddress().c_str());
         return -1;
@@ -382,12 +401,7 @@ int WorldSocket::handle_output(ACE_HANDLE)
 
     if (send_len == 0)
     {
-        Guard.release();
-        if (reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
-        {
-            return -1;
-        }
-        return 0;
+        return iCancelWakeup(Guard);
     }
 
 #ifdef MSG_NOSIGNAL
@@ -396,6 +410,12 @@ int WorldSocket::handle_output(ACE_HANDLE)
     ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
 #endif // MSG_NOSIGNAL
 
+    if (n > 0)
+    {
+        m_OutPending.fetch_sub(size_t(n), std::memory_order_relaxed);
+        m_OutSent.fetch_add(uint64(n), std::memory_order_relaxed);
+    }
+
     if (n == 0)
     {
         return -1;
@@ -434,12 +454,7 @@ int WorldSocket::handle_output(ACE_HANDLE)
 
         if (!iFlushPacketQueue()) //no more packets in queue
         {
-            Guard.release();
-            if (reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
-            {
-                return -1;
-            }
-            return 0;
+            return iCancelWakeup(Guard);
         }
         else
         {
@@ -483,17 +498,16 @@ int WorldSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
 /**
  * @brief Parses and validates an incoming packet header.
  *
+ * @param header The still encrypted header, decrypted in place.
  * @return int Zero on success; otherwise -1.
  */
-int WorldSocket::handle_input_header(void)
+int WorldSocket::handle_input_header(ClientPktHeader& header)
 {
     MANGOS_ASSERT(m_RecvWPct == NULL);
 
     MANGOS_ASSERT(m_Header.length() == sizeof(ClientPktHeader));
 
-    m_Crypt.DecryptRecv((uint8*) m_Header.rd_ptr(), sizeof(ClientPktHeader));
-
-    ClientPktHeader& header = *((ClientPktHeader*) m_Header.rd_ptr());
+    m_Crypt.DecryptRecv((uint8*) &header, sizeof(ClientPktHeader));
 
     EndianConvertReverse(header.size);
     EndianConvert(header.cmd);
@@ -509,7 +523,8 @@ int WorldSocket::handle_input_header(void)
 
     header.size -= 4;
 
-    ACE_NEW_RETURN(m_RecvWPct, WorldPacket(OpcodesList(header.cmd), header.size), -1);
+    // recycled, the buffer of a handled packet is reused
+    m_RecvWPct = sWorldPacketPool.Acquire(uint16(header.cmd), header.size);
 
     if (header.size > 0)
     {
@@ -591,21 +606,35 @@ int WorldSocket::handle_input_missing_data(void)
     {
         if (m_Header.space() > 0)
         {
-            // need to receive the header
-            const size_t to_header = (message_block.length() > m_Header.space() ? m_Header.space() : message_block.length());
-            m_Header.copy(message_block.rd_ptr(), to_header);
-            message_block.rd_ptr(to_header);
+            ClientPktHeader* header;
 
-            if (m_Header.space() > 0)
+            if (m_Header.length() == 0 && message_block.length() >= sizeof(ClientPktHeader))
             {
-                // Couldn't receive the whole header this time.
-                MANGOS_ASSERT(message_block.length() == 0);
-                errno = EWOULDBLOCK;
-                return -1;
+                // the whole header is in the received data, decrypt it where it lies
+                header = (ClientPktHeader*) message_block.rd_ptr();
+                message_block.rd_ptr(sizeof(ClientPktHeader));
+                m_Header.wr_ptr(sizeof(ClientPktHeader));
+            }
+            else
+            {
+                // need to receive the header
+                const size_t to_header = (message_block.length() > m_Header.space() ? m_Header.space() : message_block.length());
+                m_Header.copy(message_block.rd_ptr(), to_header);
+                message_block.rd_ptr(to_header);
+
+                if (m_Header.space() > 0)
+                {
+                    // Couldn't receive the whole header this time.
+                    MANGOS_ASSERT(message_block.length() == 0);
+                    errno = EWOULDBLOCK;
+                    return -1;
+                }
+
+                header = (ClientPktHeader*) m_Header.rd_ptr();
             }
 
             // We just received nice new header
-            if (handle_input_header() == -1)
+            if (handle_input_header(*header) == -1)
             {
                 MANGOS_ASSERT((errno != EWOULDBLOCK) && (errno != EAGAIN));
                 return -1;
@@ -678,6 +707,10 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
 
     // Dump received packet.
     sLog.outWorldPacketDump(uint32(get_handle()), new_pct->GetOpcode(), new_pct->GetOpcodeName(), new_pct, true);
+    if (sPacketCapture.IsEnabled())
+    {
+        sPacketCapture.Capture(uint32(get_handle()), m_AccountId.load(std::memory_order_relaxed), opcode, *new_pct, PACKET_CAPTURE_CLIENT_TO_SERVER);
+    }
 
     try
     {
@@ -961,6 +994,8 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     SqlStatement stmt = LoginDatabase.CreateStatement(updAccount, "UPDATE `account` SET `last_ip` = ? WHERE `username` = ?");
     stmt.PExecute(address.c_str(), account.c_str());
 
+    m_AccountId.store(id, std::memory_order_relaxed);
+
     // NOTE ATM the socket is single-threaded, have this in mind ...
     ACE_NEW_RETURN(m_Session, WorldSession(id, this, AccountTypes(security), expansion, mutetime, locale), -1);
 
@@ -1077,6 +1112,11 @@ int WorldSocket::iSendPacket(const WorldPacket& pct)
         sLog.outWorldPacketDump(uint32(get_handle()), pct.GetOpcode(), pct.GetOpcodeName(), &pct, false);
     }
 
+    if (sPacketCapture.IsEnabled())
+    {
+        sPacketCapture.Capture(uint32(get_handle()), m_AccountId.load(std::memory_order_relaxed), pct.GetOpcode(), pct, PACKET_CAPTURE_SERVER_TO_CLIENT);
+    }
+
     ServerPktHeader header;
 
     header.cmd = pct.GetOpcode();
@@ -1086,7 +1126,8 @@ int WorldSocket::iSendPacket(const WorldPacket& pct)
     EndianConvertReverse(header.size);
     EndianConvert(header.cmd);
 
-    m_Crypt.EncryptSend((uint8*) & header, sizeof(header));
+    // encrypted in place by iEncryptHeaders()
+    m_HeaderOffsets.push_back(m_OutBuffer->wr_ptr() - m_OutBuffer->base());
 
     if (m_OutBuffer->copy((char*) & header, sizeof(header)) == -1)
     {
@@ -1118,8 +1159,11 @@ bool WorldSocket::iFlushPacketQueue()
         {
             if (m_PacketQueue.enqueue_head(pct) == -1)
             {
+                m_OutPending.fetch_sub(pct->size() + sizeof(ServerPktHeader), std::memory_order_relaxed);
+                m_OutQueued.fetch_sub(1, std::memory_order_relaxed);
                 delete pct;
                 sLog.outError("WorldSocket::iFlushPacketQueue m_PacketQueue->enqueue_head");
+                iEncryptHeaders();
                 return false;
             }
 
@@ -1128,9 +1172,66 @@ bool WorldSocket::iFlushPacketQueue()
         else
         {
             haveone = true;
+            m_OutQueued.fetch_sub(1, std::memory_order_relaxed);
             delete pct;
         }
     }
 
+    iEncryptHeaders();
+
     return haveone;
 }
+
+/**
+ * @brief Encrypts the headers iSendPacket() wrote since the last call.
+ *
+ * A flush writes many small packets, their headers go through the crypt
+ * in one pass instead of one call per packet.
+ */
+void WorldSocket::iEncryptHeaders()
+{
+    if (m_HeaderOffsets.empty())
+    {
+        return;
+    }
+
+    m_Crypt.EncryptSendHeaders((uint8*) m_OutBuffer->base(), &m_HeaderOffsets[0], m_HeaderOffsets.size());
+    m_HeaderOffsets.clear();
+}
+
+/**
+ * @brief Stop write notifications once the output is drained
+ * @param Guard Held guard of m_OutBufferLock, released on return
+ * @return 0 on success, -1 on failure
+ *
+ * A packet queued between releasing the lock and cancelling may have
+ * scheduled a wakeup that the cancel removes, so the output is checked
+ * again afterwards and the wakeup scheduled again if needed.
+ */
+int WorldSocket::iCancelWakeup(ACE_Guard<LockType>& Guard)
+{
+    m_OutActive = false;
+    Guard.release();
+
+    if (reactor()->cancel_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
+    {
+        return -1;
+    }
+
+    Guard.acquire();
+
+    if (closing_ || (m_OutBuffer->length() == 0 && m_PacketQueue.is_empty()))
+    {
+        return 0;
+    }
+
+    m_OutActive = true;
+    Guard.release();
+
+    if (reactor()->schedule_wakeup(this, ACE_Event_Handler::WRITE_MASK) == -1)
+    {
+        return -1;
+    }
+
+    return 0;
+}
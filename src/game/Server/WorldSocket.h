@@ -49,10 +49,13 @@
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
 
+#include <vector>
+
 class ACE_Message_Block;
 class WorldPacket;
 class WorldSession;
 class WorldSocket;
+struct ClientPktHeader;
 
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 typedef ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR > WorldAcceptor;
@@ -120,6 +123,15 @@ class WorldSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket(const WorldPacket& pct);
 
+        /// Bytes accepted by SendPacket() and not yet handed to the kernel.
+        size_t GetOutPending() const { return m_OutPending.load(std::memory_order_relaxed); }
+
+        /// Packets waiting in m_PacketQueue for room in the output buffer.
+        uint32 GetOutQueued() const { return m_OutQueued.load(std::memory_order_relaxed); }
+
+        /// Bytes handed to the kernel since the socket opened.
+        uint64 GetOutSent() const { return m_OutSent.load(std::memory_order_relaxed); }
+
         /// Add reference to this object.
         long AddReference(void);
 
@@ -149,7 +161,7 @@ class WorldSocket : protected WorldHandler
 
     private:
         /// Helper functions for processing incoming data.
-        int handle_input_header(void);
+        int handle_input_header(ClientPktHeader& header);
         int handle_input_payload(void);
         int handle_input_missing_data(void);
 
@@ -164,15 +176,24 @@ class WorldSocket : protected WorldHandler
         int HandlePing(WorldPacket& recvPacket);
 
         /// Try to write WorldPacket to m_OutBuffer ,return -1 if no space
+        /// The header stays in clear until iEncryptHeaders() is called
         /// Need to be called with m_OutBufferLock lock held
         int iSendPacket(const WorldPacket& pct);
 
+        /// Encrypt the headers written by iSendPacket() in one batch
+        /// Need to be called with m_OutBufferLock lock held
+        void iEncryptHeaders();
+
         /// Flush m_PacketQueue if there are packets in it
         /// Need to be called with m_OutBufferLock lock held
         /// @return true if it wrote to the buffer ( AKA you need
         /// to mark the socket for output ).
         bool iFlushPacketQueue();
 
+        /// Stop write notifications once the output is drained.
+        /// Need to be called with m_OutBufferLock lock held, releases it.
+        int iCancelWakeup(ACE_Guard<LockType>& Guard);
+
     private:
         /// Time in which the last ping was received
         ACE_Time_Value m_LastPingTime;
@@ -189,6 +210,10 @@ class WorldSocket : protected WorldHandler
         /// Session to which received packets are routed
         WorldSession* m_Session;
 
+        /// Account of the session, kept for packet capture after the session is gone.
+        /// Set by the network thread, read by the threads sending packets.
+        std::atomic<uint32> m_AccountId;
+
         /// here are stored the fragments of the received data
         WorldPacket* m_RecvWPct;
 
@@ -209,6 +234,22 @@ class WorldSocket : protected WorldHandler
         /// Size of the m_OutBuffer.
         size_t m_OutBufferSize;
 
+        /// Offsets in m_OutBuffer of the headers not encrypted yet.
+        std::vector<size_t> m_HeaderOffsets;
+
+        /// A write wakeup is scheduled with the reactor, so queuing more
+        /// output needs no further reactor call. Guarded by m_OutBufferLock.
+        bool m_OutActive;
+
+        /// Bytes in m_OutBuffer and m_PacketQueue, readable without the lock.
+        std::atomic<size_t> m_OutPending;
+
+        /// Packets in m_PacketQueue, readable without the lock.
+        std::atomic<uint32> m_OutQueued;
+
+        /// Bytes sent so far.
+        std::atomic<uint64> m_OutSent;
+
         /// Here are stored packets for which there was no space on m_OutBuffer,
         /// this allows not-to kick player if its buffer is overflowed.
         PacketQueueT m_PacketQueue;
@@ -35,7 +35,8 @@
  * - Integration with ACE reactor pattern for async I/O
  *
  * The manager uses ACE (Adaptive Communication Environment) for portable
- * networking and the TP_Reactor for thread-per-connection handling.
+ * networking. Every network thread runs its own reactor, epoll based where
+ * ACE supports it, and owns the sockets registered with that reactor.
  *
  * @see WorldSocketMgr for the manager class
  * @see WorldSocket for individual socket handling
@@ -48,9 +49,13 @@
 #include "WorldSocket.h"
 #include "WorldSocketMgr.h"
 #include "Opcodes.h"
+#include "PacketCapture.h"
 
 #include <ace/ACE.h>
 #include <ace/TP_Reactor.h>
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+#include <ace/Dev_Poll_Reactor.h>
+#endif
 #include <ace/os_include/arpa/os_inet.h>
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
@@ -70,7 +75,7 @@
  */
 WorldSocketMgr::WorldSocketMgr()
   : m_SockOutKBuff(-1), m_SockOutUBuff(65536), m_UseNoDelay(true),
-    reactor_(NULL), acceptor_(NULL)
+    m_NextReactor(0), m_NextThread(0), acceptor_(NULL)
 {
     InitializeOpcodes();
 }
@@ -82,9 +87,9 @@ WorldSocketMgr::WorldSocketMgr()
  */
 WorldSocketMgr::~WorldSocketMgr()
 {
-    if (reactor_)
+    for (size_t i = 0; i < m_Reactors.size(); ++i)
     {
-        delete reactor_;
+        delete m_Reactors[i];
     }
     if (acceptor_)
     {
@@ -93,21 +98,45 @@ WorldSocketMgr::~WorldSocketMgr()
 }
 
 
+/**
+ * @brief Create the reactor of one network thread
+ * @return New reactor
+ *
+ * Uses epoll (or /dev/poll) where ACE supports it. As the reactor is run
+ * by a single thread it needs none of the TP_Reactor leader handoff.
+ */
+static ACE_Reactor* CreateNetworkReactor()
+{
+    ACE_Reactor_Impl* imp = 0;
+
+#if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
+    imp = new ACE_Dev_Poll_Reactor();
+    imp->max_notify_iterations(128);
+    imp->restart(1);
+#else
+    imp = new ACE_TP_Reactor();
+    imp->max_notify_iterations(128);
+#endif
+
+    return new ACE_Reactor(imp, 1);
+}
+
 /**
  * @brief Service thread main function
  * @return Always returns 0
  *
- * Runs the ACE reactor event loop for handling network events.
+ * Runs the event loop of this thread's reactor for handling network events.
  * This method runs in each network thread and processes:
- * - Socket read/write events
- * - New connection acceptances
+ * - Read/write events of the sockets owned by the thread
+ * - New connection acceptances (first thread only)
  * - Timer events
  */
 int WorldSocketMgr::svc()
 {
     DEBUG_LOG("Starting Network Thread");
 
-    reactor_->run_reactor_event_loop();
+    ACE_Reactor* reactor = m_Reactors[m_NextThread.fetch_add(1) % m_Reactors.size()];
+    reactor->run_reactor_event_loop();
 
     DEBUG_LOG("Network Thread Exitting");
     return 0;
@@ -122,9 +151,9 @@ int WorldSocketMgr::svc()
  *
  * Initializes and starts the network subsystem:
  * 1. Reads configuration (threads, buffer sizes, TCP_NODELAY)
- * 2. Creates ACE_TP_Reactor for thread-pool handling
- * 3. Opens acceptor on specified address
- * 4. Spawns network threads
+ * 2. Creates one reactor per network thread
+ * 3. Opens acceptor on the first reactor
+ * 4. Spawns network threads, each running one reactor
  *
  * Configuration options:
  * - Network.Threads: Number of network threads (default: 1)
@@ -152,15 +181,17 @@ int WorldSocketMgr::StartNetwork(ACE_INET_Addr& addr)
     m_SockOutKBuff = sConfig.GetIntDefault("Network.OutKBuff", -1);
     m_UseNoDelay = sConfig.GetBoolDefault("Network.TcpNodelay", true);
 
-    // Create thread-pool reactor for handling multiple connections
-    ACE_Reactor_Impl* imp = 0;
-    imp = new ACE_TP_Reactor();
-    imp->max_notify_iterations(128);
-    reactor_ = new ACE_Reactor(imp, 1);
+    sPacketCapture.Initialize();
+
+    // Create one reactor per thread, a socket is only ever handled by the thread of its reactor
+    for (int i = 0; i < num_threads; ++i)
+    {
+        m_Reactors.push_back(CreateNetworkReactor());
+    }
 
     acceptor_ = new WorldAcceptor;
 
-    if (acceptor_->open(addr, reactor_, ACE_NONBLOCK) == -1)
+    if (acceptor_->open(addr, m_Reactors[0], ACE_NONBLOCK) == -1)
     {
         sLog.outError("Failed to open acceptor, check if the port is free");
         return -1;
@@ -180,8 +211,9 @@ int WorldSocketMgr::StartNetwork(ACE_INET_Addr& addr)
  *
  * Gracefully shuts down the network:
  * 1. Closes acceptor (stops accepting new connections)
- * 2. Signals reactor to end event loop
+ * 2. Signals every reactor to end its event loop
  * 3. Waits for all network threads to complete
+ * 4. Stops the packet capture
  */
 void WorldSocketMgr::StopNetwork()
 {
@@ -189,11 +221,13 @@ void WorldSocketMgr::StopNetwork()
     {
         acceptor_->close();
     }
-    if (reactor_)
+    for (size_t i = 0; i < m_Reactors.size(); ++i)
     {
-        reactor_->end_reactor_event_loop();
+        m_Reactors[i]->end_reactor_event_loop();
     }
     wait();
+
+    sPacketCapture.Stop();
 }
 
 /**
@@ -205,7 +239,7 @@ void WorldSocketMgr::StopNetwork()
  * - Sets send buffer size (if configured)
  * - Enables TCP_NODELAY to reduce latency (if configured)
  * - Sets output buffer size
- * - Associates socket with the reactor
+ * - Associates socket with the reactor of one network thread, round robin
  */
 int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
 {
@@ -232,7 +266,7 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t>(m_SockOutUBuff);
-    sock->reactor(reactor_);
+    sock->reactor(m_Reactors[m_NextReactor.fetch_add(1) % m_Reactors.size()]);
 
     return 0;
 }
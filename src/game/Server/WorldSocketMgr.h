@@ -38,12 +38,16 @@
 #include <ace/Task.h>
 #include <ace/Acceptor.h>
 
+#include <atomic>
+#include <vector>
+
 class WorldSocket;
 
 /**
  * @brief World socket manager class
  *
- * This is a pool of threads designed to be used by an ACE_TP_Reactor.
+ * This is a pool of threads, each running its own reactor. A socket is
+ * registered with one reactor and all its I/O runs on that thread.
  * Manages all sockets connected to peers.
  */
 class WorldSocketMgr : public ACE_Task_Base
@@ -93,7 +97,9 @@ class WorldSocketMgr : public ACE_Task_Base
         int m_SockOutUBuff; ///< Socket output user buffer size
         bool m_UseNoDelay; ///< Use TCP_NODELAY
 
-        ACE_Reactor* reactor_; ///< ACE reactor
+        std::vector<ACE_Reactor*> m_Reactors; ///< One reactor per network thread, the first also accepts
+        std::atomic<size_t> m_NextReactor; ///< Round robin index for new sockets
+        std::atomic<size_t> m_NextThread; ///< Index of the reactor the next started thread runs
         WorldAcceptor* acceptor_; ///< World acceptor
 };
 
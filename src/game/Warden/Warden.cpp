@@ -66,7 +66,8 @@
  * - Keys and seed: zeroed
  */
 Warden::Warden() : _session(NULL), _inputCrypto(16), _outputCrypto(16), _checkTimer(10000/*10 sec*/), _clientResponseTimer(0),
-                   _module(NULL), _state(WardenState::STATE_INITIAL)
+                   _module(NULL), _state(WardenState::STATE_INITIAL), _penaltyPending(false), _penaltyReason(NULL), _penaltyCheck(NULL),
+                   _kickPending(false)
 {
     memset(_inputKey, 0, sizeof(_inputKey));
     memset(_outputKey, 0, sizeof(_outputKey));
@@ -207,9 +208,12 @@ void Warden::Update()
                 // Kick player if client response delays more than set in config
                 if (_clientResponseTimer > maxClientResponseDelay * IN_MILLISECONDS)
                 {
-                    sLog.outWarden("%s (latency: %u, IP: %s) exceeded Warden module response delay on state %s for more than %s - disconnecting client",
-                                   _session->GetPlayerName(), _session->GetLatency(), _session->GetRemoteAddress().c_str(), WardenState::to_string(_state), secsToTimeString(maxClientResponseDelay, TimeFormat::ShortText).c_str());
-                    _session->KickPlayer();
+                    if (!_kickPending)
+                    {
+                        sLog.outWarden("%s (latency: %u, IP: %s) exceeded Warden module response delay on state %s for more than %s - disconnecting client",
+                                       _session->GetPlayerName(), _session->GetLatency(), _session->GetRemoteAddress().c_str(), WardenState::to_string(_state), secsToTimeString(maxClientResponseDelay, TimeFormat::ShortText).c_str());
+                        QueueKick();
+                    }
                 }
                 else
                 {
@@ -238,6 +242,24 @@ void Warden::Update()
     }
 }
 
+/**
+ * @brief Check whether the next Update() sends a check request
+ *
+ * Lets the world thread hand only the sessions with a request due to the
+ * session update threads, the timers of the others are advanced serially.
+ *
+ * @return True if the check timer has run out
+ */
+bool Warden::IsRequestDue() const
+{
+    if (_state != WardenState::STATE_INITIALIZE_MODULE && _state != WardenState::STATE_RESTING)
+    {
+        return false;
+    }
+
+    return GameTime::GetGameTimeMS() - _previousTimestamp >= _checkTimer;
+}
+
 /**
  * @brief Decrypts an incoming Warden payload.
  *
@@ -397,6 +419,71 @@ std::string Warden::Penalty(WardenCheck* check /*= NULL*/)
     return "Undefined";
 }
 
+/**
+ * @brief Remembers a Warden failure until the world thread applies its penalty.
+ *
+ * Responses are verified on the session update threads, where banning the
+ * account or reading the player position is not safe. Only the first
+ * failure before the next ApplyPenalty() is kept.
+ *
+ * @param reason What failed, for the log.
+ * @param check The Warden check that failed, if any.
+ */
+void Warden::QueuePenalty(char const* reason, WardenCheck* check /*= NULL*/)
+{
+    if (_penaltyPending)
+    {
+        return;
+    }
+
+    _penaltyPending = true;
+    _penaltyReason = reason;
+    _penaltyCheck = check;
+}
+
+/**
+ * @brief Remembers that the client must be kicked whatever the configured action.
+ *
+ * Used when the client stops answering, the world thread kicks it in
+ * ApplyPenalty().
+ */
+void Warden::QueueKick()
+{
+    _kickPending = true;
+}
+
+/**
+ * @brief Applies and logs the queued Warden failure and kick, if any.
+ *
+ * Called by the world thread from WorldSession::Update().
+ */
+void Warden::ApplyPenalty()
+{
+    if (_penaltyPending)
+    {
+        _penaltyPending = false;
+
+        if (_penaltyCheck)
+        {
+            sLog.outWarden("%s %s %u. Action: %s", _session->GetPlayerName(), _penaltyReason, _penaltyCheck->CheckId, Penalty(_penaltyCheck).c_str());
+            LogPositiveToDB(_penaltyCheck);
+        }
+        else
+        {
+            sLog.outWarden("%s %s. Action: %s", _session->GetPlayerName(), _penaltyReason, Penalty().c_str());
+        }
+
+        _penaltyReason = NULL;
+        _penaltyCheck = NULL;
+    }
+
+    if (_kickPending)
+    {
+        _kickPending = false;
+        _session->KickPlayer();
+    }
+}
+
 /**
  * @brief Handles an incoming Warden data packet from the client.
  *
@@ -179,6 +179,7 @@ class Warden
         void SendModuleToClient();
         void RequestModule();
         void Update();
+        bool IsRequestDue() const;
         void DecryptData(uint8* buffer, uint32 length);
         void EncryptData(uint8* buffer, uint32 length);
 
@@ -190,6 +191,12 @@ class Warden
         // If no check is passed, the default action from config is executed
         std::string Penalty(WardenCheck* check = NULL);
 
+        // Client responses are verified on the session update threads, the
+        // penalty of a failure or a kick is applied later by the world thread
+        void QueuePenalty(char const* reason, WardenCheck* check = NULL);
+        void QueueKick();
+        void ApplyPenalty();
+
     protected:
         void LogPositiveToDB(WardenCheck* check);
 
@@ -204,6 +211,10 @@ class Warden
         uint32 _previousTimestamp;
         ClientWardenModule* _module;
         WardenState::Value _state;
+        bool _penaltyPending;                        // A failure waits for ApplyPenalty()
+        char const* _penaltyReason;
+        WardenCheck* _penaltyCheck;
+        bool _kickPending;                           // A kick waits for ApplyPenalty()
 };
 
 #endif
@@ -188,6 +188,52 @@ void WardenCheckMgr::LoadWardenChecks()
     sLog.outString(">> Loaded %u warden checks.", count);
 
     delete result;
+
+    BuildCheckSets();
+}
+
+/**
+ * @brief Builds the check set of every client build from the stores.
+ *
+ * Sessions draw their check ids and look up checks in these sets, instead
+ * of scanning the multimaps for every request.
+ */
+void WardenCheckMgr::BuildCheckSets()
+{
+    ACE_WRITE_GUARD(LOCK, g, m_lock)
+
+    CheckSets.clear();
+
+    for (CheckMap::const_iterator it = CheckStore.begin(); it != CheckStore.end(); ++it)
+    {
+        WardenCheckSet& checkSet = CheckSets[it->first];
+        WardenCheck* check = it->second;
+
+        if (check->Type == MEM_CHECK || check->Type == MODULE_CHECK)
+        {
+            checkSet.MemCheckIds.push_back(check->CheckId);
+        }
+
+        checkSet.CheckIds.push_back(check->CheckId);
+        checkSet.Checks[check->CheckId] = check;
+    }
+
+    for (CheckResultMap::const_iterator it = CheckResultStore.begin(); it != CheckResultStore.end(); ++it)
+    {
+        CheckSets[it->first].Results[it->second->Id] = it->second;
+    }
+}
+
+/**
+ * @brief Finds the check set of a client build.
+ *
+ * @param build The client build.
+ * @return WardenCheckSet const* The checks of the build, or NULL if it has none.
+ */
+WardenCheckSet const* WardenCheckMgr::GetCheckSet(uint16 build) const
+{
+    CheckSetMap::const_iterator it = CheckSets.find(build);
+    return it != CheckSets.end() ? &it->second : NULL;
 }
 
 /**
@@ -257,18 +303,14 @@ void WardenCheckMgr::LoadWardenOverrides()
  */
 WardenCheck* WardenCheckMgr::GetWardenDataById(uint16 build, uint16 id)
 {
-    WardenCheck* result = NULL;
-
-    ACE_READ_GUARD_RETURN(LOCK, g, m_lock, result)
-    for (CheckMap::iterator it = CheckStore.lower_bound(build); it != CheckStore.upper_bound(build); ++it)
+    WardenCheckSet const* checkSet = GetCheckSet(build);
+    if (!checkSet)
     {
-        if (it->second->CheckId == id)
-        {
-            result = it->second;
-        }
+        return NULL;
     }
 
-    return result;
+    std::map<uint16, WardenCheck*>::const_iterator it = checkSet->Checks.find(id);
+    return it != checkSet->Checks.end() ? it->second : NULL;
 }
 
 /**
@@ -280,18 +322,14 @@ WardenCheck* WardenCheckMgr::GetWardenDataById(uint16 build, uint16 id)
  */
 WardenCheckResult* WardenCheckMgr::GetWardenResultById(uint16 build, uint16 id)
 {
-    WardenCheckResult* result = NULL;
-
-    ACE_READ_GUARD_RETURN(LOCK, g, m_lock, result)
-    for (CheckResultMap::iterator it = CheckResultStore.lower_bound(build); it != CheckResultStore.upper_bound(build); ++it)
+    WardenCheckSet const* checkSet = GetCheckSet(build);
+    if (!checkSet)
     {
-        if (it->second->Id == id)
-        {
-            result = it->second;
-        }
+        return NULL;
     }
 
-    return result;
+    std::map<uint16, WardenCheckResult*>::const_iterator it = checkSet->Results.find(id);
+    return it != checkSet->Results.end() ? it->second : NULL;
 }
 
 /**
@@ -301,23 +339,14 @@ WardenCheckResult* WardenCheckMgr::GetWardenResultById(uint16 build, uint16 id)
  * @param build The client build.
  * @param idl The list that receives matching check ids.
  */
-void WardenCheckMgr::GetWardenCheckIds(bool isMemCheck, uint16 build, std::list<uint16>& idl)
+void WardenCheckMgr::GetWardenCheckIds(bool isMemCheck, uint16 build, std::vector<uint16>& idl)
 {
-    idl.clear(); //just to be sure
-
-    ACE_READ_GUARD(LOCK, g, m_lock)
-    for (CheckMap::iterator it = CheckStore.lower_bound(build); it != CheckStore.upper_bound(build); ++it)
+    WardenCheckSet const* checkSet = GetCheckSet(build);
+    if (!checkSet)
     {
-        if (isMemCheck)
-        {
-            if ((it->second->Type == MEM_CHECK) || (it->second->Type == MODULE_CHECK))
-            {
-                idl.push_back(it->second->CheckId);
-            }
-        }
-        else
-        {
-            idl.push_back(it->second->CheckId);
-        }
+        idl.clear();
+        return;
     }
+
+    idl = isMemCheck ? checkSet->MemCheckIds : checkSet->CheckIds;
 }
@@ -27,6 +27,7 @@
 #define _WARDENCHECKMGR_H
 
 #include <map>
+#include <vector>
 #include "BigNumber.h"
 
 /**
@@ -63,6 +64,20 @@ struct WardenCheckResult
     BigNumber Result; ///< Result (MEM_CHECK)
 };
 
+/**
+ * @brief Checks of one client build
+ *
+ * Built once when the checks are loaded and never changed afterwards, so
+ * sessions read it from any thread without locking.
+ */
+struct WardenCheckSet
+{
+    std::vector<uint16> MemCheckIds; ///< MEM_CHECK and MODULE_CHECK ids
+    std::vector<uint16> CheckIds; ///< All check ids
+    std::map<uint16, WardenCheck*> Checks; ///< Checks by ID
+    std::map<uint16, WardenCheckResult*> Results; ///< Expected results by check ID
+};
+
 /**
  * @brief Warden check manager class
  */
@@ -112,7 +127,7 @@ class WardenCheckMgr
          * @param build Client build
          * @param list Output list of check IDs
          */
-        void GetWardenCheckIds(bool isMemCheck /* true = MEM */, uint16 build, std::list<uint16>& list);
+        void GetWardenCheckIds(bool isMemCheck /* true = MEM */, uint16 build, std::vector<uint16>& list);
 
         /**
          * @brief Load warden checks
@@ -128,10 +143,24 @@ class WardenCheckMgr
         typedef ACE_RW_Thread_Mutex LOCK;
         typedef std::multimap<uint16, WardenCheck*> CheckMap;
         typedef std::multimap<uint16, WardenCheckResult*> CheckResultMap;
+        typedef std::map<uint16, WardenCheckSet> CheckSetMap;
+
+        /**
+         * @brief Build the check set of every build from the stores
+         */
+        void BuildCheckSets();
+
+        /**
+         * @brief Get the checks of a client build
+         * @param build Client build
+         * @return Check set, NULL if the build has no checks
+         */
+        WardenCheckSet const* GetCheckSet(uint16 build) const;
 
         LOCK m_lock; ///< Lock
         CheckMap CheckStore; ///< Check store
         CheckResultMap CheckResultStore; ///< Check result store
+        CheckSetMap CheckSets; ///< Checks by build, filled at startup before any session exists
 };
 
 #define sWardenCheckMgr WardenCheckMgr::instance()
@@ -206,11 +206,7 @@ void WardenMac::HandleHashResult(ByteBuffer &buff)
     // Verify key
     if (memcmp(buff.contents() + 1, sha1.GetDigest(), 20) != 0)
     {
-        sLog.outWarden("%s failed hash reply. Action: %s", _session->GetPlayerName(), Penalty().c_str());
-        if (sWorld.getConfig(CONFIG_UINT32_WARDEN_CLIENT_FAIL_ACTION) > uint32(WARDEN_ACTION_LOG))
-        {
-            _session->KickPlayer();
-        }
+        QueuePenalty("failed hash reply");
         return;
     }
 
@@ -315,9 +311,9 @@ void WardenMac::HandleData(ByteBuffer &buff)
         found = true;
     }
 
-    if (found && sWorld.getConfig(CONFIG_UINT32_WARDEN_CLIENT_FAIL_ACTION) > uint32(WARDEN_ACTION_LOG))
+    if (found)
     {
-        _session->KickPlayer();
+        QueuePenalty("failed data hash");
     }
     else
     {
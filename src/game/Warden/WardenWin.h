@@ -130,9 +130,9 @@ class WardenWin : public Warden
 
     private:
         uint32 _serverTicks; ///< Server ticks
-        std::list<uint16> _otherChecksTodo; ///< Other checks to do
-        std::list<uint16> _memChecksTodo; ///< Memory checks to do
-        std::list<uint16> _currentChecks; ///< Current checks
+        std::vector<uint16> _otherChecksTodo; ///< Other checks to do
+        std::vector<uint16> _memChecksTodo; ///< Memory checks to do
+        std::vector<uint16> _currentChecks; ///< Current checks
 };
 
 #endif
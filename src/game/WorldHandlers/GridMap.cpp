@@ -50,6 +50,8 @@
 #include "DBCStores.h"
 #include "GridMap.h"
 #include "VMapFactory.h"
+#include "HeightCache.h"
+#include "CollisionProfiler.h"
 #include "MoveMap.h"
 #include "World.h"
 #include "Policies/Singleton.h"
@@ -89,6 +91,11 @@ GridMap::GridMap()
     m_liquidFlags = NULL;
     m_liquidEntry = NULL;
     m_liquid_map  = NULL;
+
+    // File data
+    m_fileData = NULL;
+    m_fileSize = 0;
+    m_fileMapped = false;
 }
 
 GridMap::~GridMap()
@@ -99,6 +106,12 @@ GridMap::~GridMap()
 /**
  * @brief Loads all grid data sections from a map file.
  *
+ * The file is memory-mapped read-only and the height, area and liquid
+ * arrays point into the mapping, so loading a grid neither copies the
+ * file nor grows the heap. Instances sharing the grid share the pages
+ * in the file system cache. If the file can not be mapped it is read
+ * into a single buffer instead.
+ *
  * @param filename The .map filename to load.
  * @return true if loading succeeded or the file was absent; otherwise false.
  */
@@ -107,57 +120,61 @@ bool GridMap::loadData(char* filename)
     // Unload old data if exist
     unloadData();
 
-    GridMapFileHeader header;
     // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
+    if (!openFile(filename))
     {
         return true;
     }
 
-    fread(&header, sizeof(header), 1, in);
+    GridMapFileHeader header;
+    if (!readFileStruct(0, header))
+    {
+        sLog.outError("Map file '%s' is too small to be a map file.", filename);
+        unloadData();
+        return false;
+    }
+
     if (header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
             header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)) &&
             IsAcceptableClientBuild(header.buildMagic))
     {
         // loadup area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header.areaMapOffset && !loadAreaData(header.areaMapOffset, header.areaMapSize))
         {
             sLog.outError("Error loading map area data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup holes data
-        if (header.holesOffset && !loadHolesData(in, header.holesOffset, header.holesSize))
+        if (header.holesOffset && !loadHolesData(header.holesOffset, header.holesSize))
         {
             sLog.outError("Error loading map holes data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header.heightMapOffset && !loadHeightData(header.heightMapOffset, header.heightMapSize))
         {
             sLog.outError("Error loading map height data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup liquid data
-        if (header.liquidMapOffset && !loadGridMapLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header.liquidMapOffset && !loadGridMapLiquidData(header.liquidMapOffset, header.liquidMapSize))
         {
             sLog.outError("Error loading map liquids data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
-        fclose(in);
         return true;
     }
 
     sLog.outError("Map file '%s' is non-compatible version created with a different map-extractor version.", filename);
-    fclose(in);
+    unloadData();
     return false;
 }
 
@@ -166,12 +183,24 @@ bool GridMap::loadData(char* filename)
  */
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    for (std::vector<uint8*>::const_iterator itr = m_copiedArrays.begin(); itr != m_copiedArrays.end(); ++itr)
+    {
+        delete[] *itr;
+    }
+    m_copiedArrays.clear();
+
+    if (m_fileMapped)
+    {
+        m_fileMap.close();
+        m_fileMapped = false;
+    }
+    else
+    {
+        delete[] m_fileData;
+    }
+
+    m_fileData = NULL;
+    m_fileSize = 0;
 
     m_area_map = NULL;
     m_V9 = NULL;
@@ -182,20 +211,119 @@ void GridMap::unloadData()
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
+/**
+ * @brief Makes the content of a map file available in m_fileData.
+ *
+ * @param filename The .map filename to open.
+ * @return true if the file content is available; otherwise false.
+ */
+bool GridMap::openFile(char const* filename)
+{
+    if (m_fileMap.map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_PRIVATE) == 0)
+    {
+        // the mapping stays valid without the file handle, do not keep one open per grid
+        m_fileMap.close_handle();
+#ifdef MADV_WILLNEED
+        m_fileMap.advise(MADV_WILLNEED);
+#endif
+
+        m_fileData = static_cast<uint8 const*>(m_fileMap.addr());
+        m_fileSize = m_fileMap.size();
+        m_fileMapped = true;
+        return true;
+    }
+
+    FILE* in = fopen(filename, "rb");
+    if (!in)
+    {
+        return false;
+    }
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (size <= 0)
+    {
+        fclose(in);
+        return false;
+    }
+
+    uint8* data = new uint8[size];
+    if (fread(data, 1, size, in) != size_t(size))
+    {
+        delete[] data;
+        fclose(in);
+        return false;
+    }
+
+    fclose(in);
+
+    m_fileData = data;
+    m_fileSize = size;
+    return true;
+}
+
+/**
+ * @brief Copies a structure stored in the map file.
+ *
+ * @param offset The offset of the structure in the file.
+ * @param result Receives the structure.
+ * @return true if the structure lies within the file; otherwise false.
+ */
+template<typename T>
+bool GridMap::readFileStruct(uint32 offset, T& result) const
+{
+    if (uint64(offset) + sizeof(T) > m_fileSize)
+    {
+        return false;
+    }
+
+    memcpy(&result, m_fileData + offset, sizeof(T));
+    return true;
+}
+
+/**
+ * @brief Returns an array stored in the map file.
+ *
+ * The array is used in place if it is suitably aligned for its element
+ * type, otherwise it is copied.
+ *
+ * @param offset The offset of the array in the file.
+ * @param count The number of elements.
+ * @return The array, or NULL if it does not lie within the file.
+ */
+template<typename T>
+T const* GridMap::getFileArray(uint32 offset, uint32 count)
+{
+    size_t bytes = count * sizeof(T);
+    if (uint64(offset) + bytes > m_fileSize)
+    {
+        return NULL;
+    }
+
+    uint8 const* data = m_fileData + offset;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0)
+    {
+        return reinterpret_cast<T const*>(data);
+    }
+
+    uint8* copy = new uint8[bytes];
+    memcpy(copy, data, bytes);
+    m_copiedArrays.push_back(copy);
+    return reinterpret_cast<T const*>(copy);
+}
+
 /**
  * @brief Loads area id data for the grid.
  *
- * @param in The opened map file.
  * @param offset The section offset.
  * @param size The section size.
  * @return true if the section was loaded successfully; otherwise false.
  */
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
 {
     GridMapAreaHeader header;
-    fseek(in, offset, SEEK_SET);
-    size_t file_read = fread(&header, sizeof(header), 1, in);
-    if (file_read <= 0)
+    if (!readFileStruct(offset, header))
     {
         return false;
     }
@@ -207,9 +335,8 @@ bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
     m_gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        file_read = fread(m_area_map, sizeof(uint16), 16 * 16, in);
-        if (file_read <= 0)
+        m_area_map = getFileArray<uint16>(offset + sizeof(header), 16 * 16);
+        if (!m_area_map)
         {
             return false;
         }
@@ -221,17 +348,14 @@ bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
 /**
  * @brief Loads terrain height data for the grid.
  *
- * @param in The opened map file.
  * @param offset The section offset.
  * @param size The section size.
  * @return true if the section was loaded successfully; otherwise false.
  */
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
 {
     GridMapHeightHeader header;
-    fseek(in, offset, SEEK_SET);
-    size_t file_read = fread(&header, sizeof(header), 1, in);
-    if (file_read <= 0)
+    if (!readFileStruct(offset, header))
     {
         return false;
     }
@@ -240,20 +364,16 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
         return false;
     }
 
+    offset += sizeof(header);
+
     m_gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129 * 129];
-            m_uint16_V8 = new uint16 [128 * 128];
-            file_read = fread(m_uint16_V9, sizeof(uint16), 129 * 129, in);
-            if (file_read <= 0)
-            {
-                return false;
-            }
-            file_read = fread(m_uint16_V8, sizeof(uint16), 128 * 128, in);
-            if (file_read <= 0)
+            m_uint16_V9 = getFileArray<uint16>(offset, 129 * 129);
+            m_uint16_V8 = getFileArray<uint16>(offset + 129 * 129 * sizeof(uint16), 128 * 128);
+            if (!m_uint16_V9 || !m_uint16_V8)
             {
                 return false;
             }
@@ -262,15 +382,9 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129 * 129];
-            m_uint8_V8 = new uint8 [128 * 128];
-            file_read = fread(m_uint8_V9, sizeof(uint8), 129 * 129, in);
-            if (file_read <= 0)
-            {
-                return false;
-            }
-            file_read = fread(m_uint8_V8, sizeof(uint8), 128 * 128, in);
-            if (file_read <= 0)
+            m_uint8_V9 = getFileArray<uint8>(offset, 129 * 129);
+            m_uint8_V8 = getFileArray<uint8>(offset + 129 * 129 * sizeof(uint8), 128 * 128);
+            if (!m_uint8_V9 || !m_uint8_V8)
             {
                 return false;
             }
@@ -279,15 +393,9 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
         }
         else
         {
-            m_V9 = new float [129 * 129];
-            m_V8 = new float [128 * 128];
-            file_read = fread(m_V9, sizeof(float), 129 * 129, in);
-            if (file_read <= 0)
-            {
-                return false;
-            }
-            file_read = fread(m_V8, sizeof(float), 128 * 128, in);
-            if (file_read <= 0)
+            m_V9 = getFileArray<float>(offset, 129 * 129);
+            m_V8 = getFileArray<float>(offset + 129 * 129 * sizeof(float), 128 * 128);
+            if (!m_V9 || !m_V8)
             {
                 return false;
             }
@@ -305,39 +413,26 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
 /**
  * @brief Loads terrain hole masks for the grid.
  *
- * @param in The opened map file.
  * @param offset The section offset.
  * @param size The section size.
  * @return true if the section was loaded successfully; otherwise false.
  */
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 size)
+bool GridMap::loadHolesData(uint32 offset, uint32 /*size*/)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
-    {
-        return false;
-    }
-
-    if (fread(&m_holes, sizeof(m_holes), 1, in) != 1)
-    {
-        return false;
-    }
-    return true;
+    return readFileStruct(offset, m_holes);
 }
 
 /**
  * @brief Loads liquid metadata and height data for the grid.
  *
- * @param in The opened map file.
  * @param offset The section offset.
  * @param size The section size.
  * @return true if the section was loaded successfully; otherwise false.
  */
-bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadGridMapLiquidData(uint32 offset, uint32 /*size*/)
 {
     GridMapLiquidHeader header;
-    fseek(in, offset, SEEK_SET);
-    size_t file_read = fread(&header, sizeof(header), 1, in);
-    if (file_read <= 0)
+    if (!readFileStruct(offset, header))
     {
         return false;
     }
@@ -346,6 +441,8 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
         return false;
     }
 
+    offset += sizeof(header);
+
     m_liquidType    = header.liquidType;
     m_liquid_offX   = header.offsetX;
     m_liquid_offY   = header.offsetY;
@@ -355,16 +452,11 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        file_read = fread(m_liquidEntry, sizeof(uint16), 16 * 16, in);
-        if (file_read <= 0)
-        {
-            return false;
-        }
-
-        m_liquidFlags = new uint8[16 * 16];
-        file_read = fread(m_liquidFlags, sizeof(uint8), 16 * 16, in);
-        if (file_read <= 0)
+        m_liquidEntry = getFileArray<uint16>(offset, 16 * 16);
+        offset += 16 * 16 * sizeof(uint16);
+        m_liquidFlags = getFileArray<uint8>(offset, 16 * 16);
+        offset += 16 * 16 * sizeof(uint8);
+        if (!m_liquidEntry || !m_liquidFlags)
         {
             return false;
         }
@@ -372,9 +464,8 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float [m_liquid_width * m_liquid_height];
-        file_read = fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in);
-        if (file_read <= 0)
+        m_liquid_map = getFileArray<float>(offset, m_liquid_width * m_liquid_height);
+        if (!m_liquid_map)
         {
             return false;
         }
@@ -556,7 +647,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint8* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -633,7 +724,7 @@ float GridMap::getHeightFromUint16(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint16* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -937,8 +1028,10 @@ bool GridMap::ExistVMap(uint32 mapid, int gx, int gy)
 }
 
 //////////////////////////////////////////////////////////////////////////
-TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_refMutex(), m_mutex()
+TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_vmapGeneration(0), m_refMutex(), m_mutex()
 {
+    NextVMapGeneration();
+
     for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
     {
         for (int i = 0; i < MAX_NUMBER_OF_GRIDS; ++i)
@@ -971,6 +1064,19 @@ TerrainInfo::~TerrainInfo()
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
 }
 
+/**
+ * @brief Moves the vmap generation on after a vmap tile was loaded or unloaded.
+ *
+ * Generations come from one counter shared by all terrains, so a terrain
+ * created again for the same map never repeats the generation of cache
+ * entries from before it was unloaded.
+ */
+void TerrainInfo::NextVMapGeneration()
+{
+    static std::atomic<uint32> lastGeneration(0);
+    m_vmapGeneration.store(lastGeneration.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
 /**
  * @brief Loads and references a grid by grid indices.
  *
@@ -1038,6 +1144,7 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
 
                 // unload VMAPS...
                 VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+                NextVMapGeneration();
 
                 // unload mmap...
                 MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
@@ -1098,6 +1205,34 @@ int TerrainInfo::UnrefGrid(const uint32& x, const uint32& y)
  * @return The best matching terrain height.
  */
 float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
+{
+    CollisionProfileScope profileScope(COLLISION_QUERY_HEIGHT);
+
+    // a capture records what the vmaps answer, so bypass the height cache while it runs
+    bool capturing = sCollisionProfiler.IsCapturing();
+    float height = CalculateHeightStatic(x, y, z, useVmaps, maxSearchDist, !capturing);
+
+    if (capturing)
+    {
+        CollisionQueryRecord rec = { COLLISION_QUERY_HEIGHT, GetMapId(), x, y, z, 0.0f, 0.0f, 0.0f, maxSearchDist, useVmaps, height, 0, 0, 0, 0 };
+        sCollisionProfiler.Capture(rec);
+    }
+
+    return height;
+}
+
+/**
+ * @brief Calculates the static terrain height for a position.
+ *
+ * @param x The world x coordinate.
+ * @param y The world y coordinate.
+ * @param z The search reference z coordinate.
+ * @param useVmaps Whether VMaps should be consulted.
+ * @param maxSearchDist The maximum VMap search distance.
+ * @param useCache Whether VMap floors may be served from the height cache.
+ * @return The best matching terrain height.
+ */
+float TerrainInfo::CalculateHeightStatic(float x, float y, float z, bool useVmaps, float maxSearchDist, bool useCache) const
 {
     float mapHeight = VMAP_INVALID_HEIGHT_VALUE;            // Store Height obtained by maps
     float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;           // Store Height obtained by vmaps (in "corridor" of z (or slightly above z)
@@ -1124,18 +1259,18 @@ float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=tr
             }
 
             // look from a bit higher pos to find the floor
-            vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, maxSearchDist);
+            vmapHeight = GetVMapHeight(x, y, z2, maxSearchDist, useCache);
 
             // if not found in expected range, look for infinity range (case of far above floor, but below terrain-height)
             if (vmapHeight <= INVALID_HEIGHT)
             {
-                vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, 10000.0f);
+                vmapHeight = GetVMapHeight(x, y, z2, 10000.0f, useCache);
             }
 
             // still not found, look near terrain height
             if (vmapHeight <= INVALID_HEIGHT && mapHeight > INVALID_HEIGHT && z2 < mapHeight)
             {
-                vmapHeight = vmgr->getHeight(GetMapId(), x, y, mapHeight + 2.0f, DEFAULT_HEIGHT_SEARCH);
+                vmapHeight = GetVMapHeight(x, y, mapHeight + 2.0f, DEFAULT_HEIGHT_SEARCH, useCache);
             }
         }
     }
@@ -1164,6 +1299,43 @@ float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=tr
     return mapHeight;                                        // better use .map surface height
 }
 
+/**
+ * @brief Returns the vmap floor under a position, served from the height cache when possible.
+ *
+ * @param x The world x coordinate.
+ * @param y The world y coordinate.
+ * @param z The height the downward ray starts at.
+ * @param maxSearchDist The maximum length of the ray.
+ * @param useCache Whether the floor may be served from the height cache.
+ * @return The floor height, or an invalid height if none was found.
+ */
+float TerrainInfo::GetVMapHeight(float x, float y, float z, float maxSearchDist, bool useCache) const
+{
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    if (!useCache || !sWorld.getConfig(CONFIG_BOOL_VMAP_HEIGHT_CACHE))
+    {
+        return vmgr->getHeight(GetMapId(), x, y, z, maxSearchDist);
+    }
+
+    // read before the ray is cast, a tile loaded meanwhile then invalidates the stored floor
+    uint32 generation = GetVMapGeneration();
+
+    HeightCache& cache = HeightCache::ForThisThread();
+    float height;
+    if (cache.Lookup(GetMapId(), generation, x, y, z, maxSearchDist, height))
+    {
+        return height;
+    }
+
+    height = vmgr->getHeight(GetMapId(), x, y, z, maxSearchDist);
+    if (height > INVALID_HEIGHT)
+    {
+        cache.Store(GetMapId(), generation, x, y, z, height);
+    }
+
+    return height;
+}
+
 /**
  * @brief Checks whether a WMO group is flagged as outdoors.
  *
@@ -1217,10 +1389,15 @@ bool TerrainInfo::IsOutdoors(float x, float y, float z) const
  */
 bool TerrainInfo::GetAreaInfo(float x, float y, float z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
 {
+    CollisionProfileScope profileScope(COLLISION_QUERY_AREA_INFO);
+
+    bool found = false;
     float vmap_z = z;
     VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
     if (vmgr->getAreaInfo(GetMapId(), x, y, vmap_z, flags, adtId, rootId, groupId))
     {
+        found = true;
+
         // check if there's terrain between player height and object height
         if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(x, y))
         {
@@ -1228,12 +1405,25 @@ bool TerrainInfo::GetAreaInfo(float x, float y, float z, uint32& flags, int32& a
             // z + 2.0f condition taken from GetHeightStatic(), not sure if it's such a great choice...
             if (z + 2.0f > _mapheight &&  _mapheight > vmap_z)
             {
-                return false;
+                found = false;
             }
         }
-        return true;
     }
-    return false;
+
+    if (sCollisionProfiler.IsCapturing())
+    {
+        CollisionQueryRecord rec = { COLLISION_QUERY_AREA_INFO, GetMapId(), x, y, z, 0.0f, 0.0f, 0.0f, 0.0f, found, 0.0f, 0, 0, 0, 0 };
+        if (found)
+        {
+            rec.mogpFlags = flags;
+            rec.adtId = adtId;
+            rec.rootId = rootId;
+            rec.groupId = groupId;
+        }
+        sCollisionProfiler.Capture(rec);
+    }
+
+    return found;
 }
 
 /**
@@ -1569,6 +1759,7 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
             const char* mapName = i_mapEntry ? i_mapEntry->name[sWorld.GetDefaultDbcLocale()] : "UNNAMEDMAP\x0";
 
             int vmapLoadResult = VMAP::VMapFactory::createOrGetVMapManager()->loadMap((sWorld.GetDataPath() + "vmaps").c_str(),  m_mapId, x, y);
+            NextVMapGeneration();
             switch (vmapLoadResult)
             {
                 case VMAP::VMAP_LOAD_RESULT_OK:
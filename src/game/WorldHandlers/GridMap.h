@@ -29,8 +29,12 @@
 #include "Policies/Singleton.h"
 #include "GridDefines.h"
 
+#include <ace/Mem_Map.h>
+
+#include <atomic>
 #include <bitset>
 #include <list>
+#include <vector>
 
 class Creature;
 class Unit;
@@ -129,22 +133,22 @@ class GridMap
 
         // Area data
         uint16 m_gridArea;
-        uint16* m_area_map;
+        uint16 const* m_area_map;
 
         // Height level data
         float m_gridHeight;
         float m_gridIntHeightMultiplier;
         union
         {
-            float* m_V9;
-            uint16* m_uint16_V9;
-            uint8* m_uint8_V9;
+            float const* m_V9;
+            uint16 const* m_uint16_V9;
+            uint8 const* m_uint8_V9;
         };
         union
         {
-            float* m_V8;
-            uint16* m_uint16_V8;
-            uint8* m_uint8_V8;
+            float const* m_V8;
+            uint16 const* m_uint16_V8;
+            uint8 const* m_uint8_V8;
         };
 
         // Liquid data
@@ -154,14 +158,25 @@ class GridMap
         uint8 m_liquid_width;
         uint8 m_liquid_height;
         float m_liquidLevel;
-        uint16* m_liquidEntry;
-        uint8* m_liquidFlags;
-        float* m_liquid_map;
-
-        bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-        bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-        bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
-        bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        uint16 const* m_liquidEntry;
+        uint8 const* m_liquidFlags;
+        float const* m_liquid_map;
+
+        // File data, the arrays above point into it
+        ACE_Mem_Map m_fileMap;
+        uint8 const* m_fileData;                            // mapped file, or a heap copy if it could not be mapped
+        size_t m_fileSize;
+        bool m_fileMapped;
+        std::vector<uint8*> m_copiedArrays;                 // copies of arrays not aligned in the file
+
+        bool openFile(char const* filename);
+        template<typename T> bool readFileStruct(uint32 offset, T& result) const;
+        template<typename T> T const* getFileArray(uint32 offset, uint32 count);
+
+        bool loadAreaData(uint32 offset, uint32 size);
+        bool loadHeightData(uint32 offset, uint32 size);
+        bool loadGridMapLiquidData(uint32 offset, uint32 size);
+        bool loadHolesData(uint32 offset, uint32 size);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -225,6 +240,9 @@ class TerrainInfo : public Referencable<AtomicLong>
 
         uint32 GetMapId() const { return m_mapId; }
 
+        /// Changes whenever a vmap tile of the map is loaded or unloaded, query caches compare it
+        uint32 GetVMapGeneration() const { return m_vmapGeneration.load(std::memory_order_acquire); }
+
         // TODO: move all terrain/vmaps data info query functions
         // from 'Map' class into this class
         float GetHeightStatic(float x, float y, float z, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
@@ -254,6 +272,7 @@ class TerrainInfo : public Referencable<AtomicLong>
 
     protected:
         friend class Map;
+        friend class CollisionProfiler;                     // replays height queries past the height cache
         // load/unload terrain data
         GridMap* Load(const uint32 x, const uint32 y);
         void Unload(const uint32 x, const uint32 y);
@@ -264,11 +283,16 @@ class TerrainInfo : public Referencable<AtomicLong>
 
         GridMap* GetGrid(const float x, const float y);
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
+        void NextVMapGeneration();
+
+        float CalculateHeightStatic(float x, float y, float z, bool useVmaps, float maxSearchDist, bool useCache) const;
+        float GetVMapHeight(float x, float y, float z, float maxSearchDist, bool useCache) const;
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
 
         const uint32 m_mapId;
+        std::atomic<uint32> m_vmapGeneration;
 
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
@@ -179,6 +179,69 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
     }
 }
 
+/**
+ * @brief Delivers a movement packet to camera owners near the mover, except one receiver.
+ *
+ * @param m The camera map to visit.
+ */
+void MovementDeliverer::Visit(CameraMapType& m)
+{
+    for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* owner = iter->getSource()->GetOwner();
+
+        if (owner == i_skipped_receiver)
+        {
+            continue;
+        }
+
+        if (i_dist && !iter->getSource()->GetBody()->IsWithinDist(&i_mover, i_dist))
+        {
+            continue;
+        }
+
+        if (WorldSession* session = owner->GetSession())
+        {
+            // a client falling behind gets the next heartbeat, it extrapolates until then
+            if (i_congestedDist && session->IsSendCongested() && !iter->getSource()->GetBody()->IsWithinDist(&i_mover, i_congestedDist))
+            {
+                continue;
+            }
+
+            session->SendPacket(i_message);
+        }
+    }
+}
+
+/**
+ * @brief Delivers a cosmetic packet to nearby cameras whose client keeps up.
+ *
+ * The source player is skipped, WorldObject::SendCosmeticMessageToSet()
+ * sends it its own packet.
+ *
+ * @param m The camera map to visit.
+ */
+void CosmeticMessageDeliverer::Visit(CameraMapType& m)
+{
+    for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* owner = iter->getSource()->GetOwner();
+
+        if (owner == &i_source)
+        {
+            continue;
+        }
+
+        if (WorldSession* session = owner->GetSession())
+        {
+            if (!session->IsSendCongested())
+            {
+                session->SendPacket(i_message);
+            }
+        }
+    }
+}
+
 /**
  * @brief Delivers an object-scoped packet to all camera owners in the visited set.
  *
@@ -195,6 +258,28 @@ void ObjectMessageDeliverer::Visit(CameraMapType& m)
     }
 }
 
+/**
+ * @brief Delivers a packet to all nearby cameras except those of skipped players.
+ *
+ * @param m The camera map to visit.
+ */
+void ObjectMessageDelivererExcept::Visit(CameraMapType& m)
+{
+    for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* owner = iter->getSource()->GetOwner();
+        if (i_skipped.find(owner->GetObjectGuid()) != i_skipped.end())
+        {
+            continue;
+        }
+
+        if (WorldSession* session = owner->GetSession())
+        {
+            session->SendPacket(i_message);
+        }
+    }
+}
+
 /**
  * @brief Delivers a packet to nearby cameras within an optional distance filter.
  *
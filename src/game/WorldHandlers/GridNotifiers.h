@@ -80,6 +80,32 @@ namespace MaNGOS
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
+    struct MovementDeliverer
+    {
+        WorldObject const& i_mover;
+        WorldPacket*  i_message;
+        Player const* i_skipped_receiver;
+        float i_dist;                                       // 0 for all observers in the visited cells
+
+        float i_congestedDist;                              // observers with a send backlog only within it, 0 for all
+
+        MovementDeliverer(WorldObject const& mover, WorldPacket* msg, Player const* skipped, float dist)
+            : i_mover(mover), i_message(msg), i_skipped_receiver(skipped), i_dist(dist), i_congestedDist(0.0f) {}
+
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
+    struct CosmeticMessageDeliverer
+    {
+        WorldObject const& i_source;
+        WorldPacket* i_message;
+
+        CosmeticMessageDeliverer(WorldObject const& source, WorldPacket* msg) : i_source(source), i_message(msg) {}
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct ObjectMessageDeliverer
     {
         WorldPacket* i_message;
@@ -88,6 +114,15 @@ namespace MaNGOS
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
+    struct ObjectMessageDelivererExcept
+    {
+        WorldPacket* i_message;
+        GuidSet const& i_skipped;                           // owners of these cameras do not receive the packet
+        ObjectMessageDelivererExcept(WorldPacket* msg, GuidSet const& skipped) : i_message(msg), i_skipped(skipped) {}
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct MessageDistDeliverer
     {
         Player const& i_player;
@@ -58,11 +58,14 @@
 #include "DBCEnums.h"
 #include "MapPersistentStateMgr.h"
 #include "VMapFactory.h"
+#include "CollisionProfiler.h"
 #include "MoveMap.h"
 #include "Chat.h"
 #include "Weather.h"
 #include "Transports.h"
 #include "ObjectGridLoader.h"
+#include "movement/MoveSpline.h"
+#include "movement/MoveSplineInit.h"
 
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
@@ -121,9 +124,6 @@ Map::~Map()
     delete i_data;
     i_data = NULL;
 
-    // unload instance specific navigation data
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
-
     // release reference count
     if (m_TerrainData->Release())
     {
@@ -179,7 +179,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
       m_cinematicViewerRadius(0.0f), m_persistentState(NULL),
-      m_activeNonPlayersIter(m_activeNonPlayers.end()),
+      m_updating(false), m_activeNonPlayersIter(m_activeNonPlayers.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
       i_data(NULL)
 {
@@ -202,6 +202,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
         {
             // z code
             m_bLoadedGrids[idx][j] = false;
+            m_bPreloadedGrids[idx][j] = false;
             setNGrid(NULL, idx, j);
         }
     }
@@ -745,6 +746,68 @@ void Map::MessageBroadcast(WorldObject const* obj, WorldPacket* msg)
     cell.Visit(p, message, *this, *obj, GetBroadcastRadius());
 }
 
+/**
+ * @brief Broadcasts a packet from an object to nearby players, except some.
+ *
+ * @param obj The source object.
+ * @param msg The packet to send.
+ * @param skipped Players that do not receive the packet.
+ */
+void Map::MessageBroadcast(WorldObject const* obj, WorldPacket* msg, GuidSet const& skipped)
+{
+    CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
+
+    if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+    {
+        sLog.outError("Map::MessageBroadcast: Object (GUID: %u TypeId: %u) have invalid coordinates X:%f Y:%f grid cell [%u:%u]", obj->GetGUIDLow(), obj->GetTypeId(), obj->GetPositionX(), obj->GetPositionY(), p.x_coord, p.y_coord);
+        return;
+    }
+
+    Cell cell(p);
+    cell.SetNoCreate();
+
+    if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
+    {
+        return;
+    }
+
+    MaNGOS::ObjectMessageDelivererExcept post_man(msg, skipped);
+    TypeContainerVisitor<MaNGOS::ObjectMessageDelivererExcept, WorldTypeMapContainer > message(post_man);
+    cell.Visit(p, message, *this, *obj, GetBroadcastRadius());
+}
+
+/**
+ * @brief Broadcasts a cosmetic packet, like an emote, to nearby players.
+ *
+ * Players whose client falls behind do not get it, nor does the source
+ * player itself (see WorldObject::SendCosmeticMessageToSet).
+ *
+ * @param obj The source object.
+ * @param msg The packet to send.
+ */
+void Map::CosmeticMessageBroadcast(WorldObject const* obj, WorldPacket* msg)
+{
+    CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
+
+    if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+    {
+        sLog.outError("Map::CosmeticMessageBroadcast: Object (GUID: %u TypeId: %u) have invalid coordinates X:%f Y:%f grid cell [%u:%u]", obj->GetGUIDLow(), obj->GetTypeId(), obj->GetPositionX(), obj->GetPositionY(), p.x_coord, p.y_coord);
+        return;
+    }
+
+    Cell cell(p);
+    cell.SetNoCreate();
+
+    if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
+    {
+        return;
+    }
+
+    MaNGOS::CosmeticMessageDeliverer post_man(*obj, msg);
+    TypeContainerVisitor<MaNGOS::CosmeticMessageDeliverer, WorldTypeMapContainer > message(post_man);
+    cell.Visit(p, message, *this, *obj, GetBroadcastRadius());
+}
+
 /**
  * @brief Broadcasts a packet from a player to objects within a fixed distance.
  *
@@ -825,6 +888,7 @@ bool Map::loaded(const GridPair& p) const
  */
 void Map::Update(const uint32& t_diff)
 {
+    m_updating = true;
     m_dyn_tree.update(t_diff);
 
     /// update worldsessions for existing players
@@ -976,6 +1040,10 @@ void Map::Update(const uint32& t_diff)
     }
 
     m_weatherSystem->UpdateWeathers(t_diff);
+
+    SendMovements();
+    SendSplineLaunches();
+    m_updating = false;
 }
 
 /**
@@ -1130,6 +1198,9 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     Cell new_cell(new_val);
     bool same_cell = (new_cell == old_cell);
 
+    float dx = x - player->GetPositionX();
+    float dy = y - player->GetPositionY();
+
     player->Relocate(x, y, z, orientation);
 
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
@@ -1159,6 +1230,61 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
         ResetGridExpiry(*newGrid, 0.1f);
         newGrid->SetGridState(GRID_STATE_ACTIVE);
     }
+
+    PreloadGridAhead(player, dx, dy);
+}
+
+/**
+ * @brief Queues read-ahead of the terrain files of the grid a player is heading to.
+ *
+ * The position is extrapolated along the last movement step for
+ * GridPreloadTime seconds at the player's current speed.
+ *
+ * @param player The moving player.
+ * @param dx The X component of the last movement step.
+ * @param dy The Y component of the last movement step.
+ */
+void Map::PreloadGridAhead(Player* player, float dx, float dy)
+{
+    uint32 preloadTime = sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_TIME);
+    if (!preloadTime)
+    {
+        return;
+    }
+
+    float step = sqrt(dx * dx + dy * dy);
+    if (step < 0.1f)
+    {
+        return;
+    }
+
+    float speed = std::max(player->GetSpeed(MOVE_RUN), player->GetSpeed(MOVE_FLIGHT));
+    float lookahead = speed * preloadTime / step;
+
+    float x = player->GetPositionX() + dx * lookahead;
+    float y = player->GetPositionY() + dy * lookahead;
+    if (!MaNGOS::IsValidMapCoord(x, y))
+    {
+        return;
+    }
+
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    if (p.x_coord >= MAX_NUMBER_OF_GRIDS || p.y_coord >= MAX_NUMBER_OF_GRIDS || loaded(p))
+    {
+        return;
+    }
+
+    int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+    if (m_bLoadedGrids[gx][gy] || m_bPreloadedGrids[gx][gy])
+    {
+        return;
+    }
+
+    if (sMapMgr.ScheduleGridPreload(i_id, gx, gy))
+    {
+        m_bPreloadedGrids[gx][gy] = true;
+    }
 }
 
 /**
@@ -1304,6 +1430,7 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
     if (m_bLoadedGrids[gx][gy])
     {
         m_bLoadedGrids[gx][gy] = false;
+        m_bPreloadedGrids[gx][gy] = false;
         m_TerrainData->Unload(gx, gy);
     }
 
@@ -2648,6 +2775,201 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
     return NULL;
 }
 
+/**
+ * @brief Defers sending the spline a unit just launched until the end of the map update.
+ *
+ * AI and movement generators often relaunch a spline several times within one
+ * update (target moved, chase restarted, speed changed). Only the spline still
+ * running when the update ends is sent, the others never reach the clients.
+ *
+ * @param unit The unit that launched a spline.
+ * @return true if the send was deferred, false if it must be sent right away.
+ */
+bool Map::DeferSplineLaunch(Unit const* unit)
+{
+    if (!m_updating)
+    {
+        return false;
+    }
+
+    i_pendingSplineLaunches[unit->GetObjectGuid()].splineId = unit->movespline->GetId();
+    return true;
+}
+
+/**
+ * @brief Notes that a create block carrying a unit's spline was built for a player.
+ *
+ * The create block already holds the spline and the time it has run, so the
+ * deferred launch of that same spline is not sent to the player again.
+ *
+ * @param unit The moving unit.
+ * @param receiver The player the create block was built for.
+ */
+void Map::OnSplineSentInCreate(Unit const* unit, Player const* receiver)
+{
+    if (!m_updating)
+    {
+        return;
+    }
+
+    PendingSplineLaunches::iterator itr = i_pendingSplineLaunches.find(unit->GetObjectGuid());
+    if (itr != i_pendingSplineLaunches.end())
+    {
+        itr->second.createdFor[receiver->GetObjectGuid()] = unit->movespline->GetId();
+    }
+}
+
+/**
+ * @brief Sends the splines launched during this map update.
+ *
+ * A spline replaced by a later launch or a stop has another id by now and is
+ * skipped. So is an interrupted one, a spline that already reached its end is
+ * still sent so clients see the unit arrive. A spline that has run for a while
+ * since its launch is sent from the current position on, see
+ * Movement::PacketBuilder::IsResumed().
+ */
+void Map::SendSplineLaunches()
+{
+    for (PendingSplineLaunches::const_iterator itr = i_pendingSplineLaunches.begin(); itr != i_pendingSplineLaunches.end(); ++itr)
+    {
+        Unit* unit = GetUnit(itr->first);
+        if (!unit || !unit->IsInWorld() || unit->GetMap() != this)
+        {
+            continue;
+        }
+
+        Movement::MoveSpline const& spline = *unit->movespline;
+        if (spline.GetId() != itr->second.splineId || (spline.Finalized() && spline.timePassed() < spline.Duration()))
+        {
+            continue;
+        }
+
+        // players that saw the unit appear this update got this spline with the create block
+        GuidSet skipped;
+        for (std::map<ObjectGuid, uint32>::const_iterator created = itr->second.createdFor.begin(); created != itr->second.createdFor.end(); ++created)
+        {
+            if (created->second == spline.GetId())
+            {
+                skipped.insert(created->first);
+            }
+        }
+
+        if (skipped.empty())
+        {
+            Movement::MoveSplineInit::SendLaunched(*unit);
+            continue;
+        }
+
+        WorldPacket data;
+        Movement::MoveSplineInit::BuildLaunched(*unit, data);
+        MessageBroadcast(unit, &data, skipped);
+    }
+
+    i_pendingSplineLaunches.clear();
+}
+
+/**
+ * @brief Broadcasts a client movement packet of a mover to the players around it.
+ *
+ * While the map updates, heartbeats and facing changes are only recorded: a
+ * mover turning with the mouse sends many of them per update and only the last
+ * one is sent when the update ends. Any other movement packet is sent right away
+ * and replaces a recorded one, which is older.
+ *
+ * @param mover The unit that moved.
+ * @param controller The player controlling the mover, it does not receive the packet.
+ * @param data The movement packet.
+ */
+void Map::BroadcastMovement(Unit const* mover, Player const* controller, WorldPacket& data)
+{
+    uint16 opcode = data.GetOpcode();
+    if (m_updating && (opcode == MSG_MOVE_HEARTBEAT || opcode == MSG_MOVE_SET_FACING))
+    {
+        PendingMovement& movement = i_pendingMovements[mover->GetObjectGuid()];
+        movement.packet = data;
+        movement.controller = controller->GetObjectGuid();
+        movement.pending = true;
+        movement.x = mover->GetPositionX();
+        movement.y = mover->GetPositionY();
+        movement.z = mover->GetPositionZ();
+        return;
+    }
+
+    PendingMovements::iterator itr = i_pendingMovements.find(mover->GetObjectGuid());
+    if (itr != i_pendingMovements.end())
+    {
+        itr->second.pending = false;
+    }
+
+    mover->SendMessageToSetExcept(&data, controller);
+}
+
+/**
+ * @brief Sends the movement packets recorded during this map update.
+ *
+ * Heartbeats only reach observers farther than Visibility.Movement.FarDistance
+ * once per Visibility.Movement.FarInterval, clients extrapolate the movement in
+ * between. A mover that was moved by other means since (teleport, knockback) or
+ * left the map is skipped, its recorded position is stale.
+ */
+void Map::SendMovements()
+{
+    uint32 now = GameTime::GetGameTimeMS();
+    float farDistance = sWorld.getConfig(CONFIG_FLOAT_MOVEMENT_FAR_DISTANCE);
+    uint32 farInterval = sWorld.getConfig(CONFIG_UINT32_MOVEMENT_FAR_INTERVAL);
+
+    for (PendingMovements::iterator itr = i_pendingMovements.begin(); itr != i_pendingMovements.end();)
+    {
+        PendingMovement& movement = itr->second;
+        if (!movement.pending)
+        {
+            // keep the far observer timer as long as it throttles anything
+            if (getMSTimeDiff(movement.farSentTime, now) >= farInterval)
+            {
+                i_pendingMovements.erase(itr++);
+            }
+            else
+            {
+                ++itr;
+            }
+            continue;
+        }
+
+        movement.pending = false;
+
+        // passengers are moved along with their transport, their packet holds the offset on it
+        Unit* mover = GetUnit(itr->first);
+        if (!mover || !mover->IsInWorld() || mover->GetMap() != this ||
+            (!mover->m_movementInfo.HasMovementFlag(MOVEFLAG_ONTRANSPORT) &&
+             (mover->GetPositionX() != movement.x || mover->GetPositionY() != movement.y || mover->GetPositionZ() != movement.z)))
+        {
+            ++itr;
+            continue;
+        }
+
+        MaNGOS::MovementDeliverer notifier(*mover, &movement.packet, GetPlayer(movement.controller), 0.0f);
+        float radius = GetBroadcastRadius();
+        if (farDistance > 0.0f && farDistance < radius && movement.packet.GetOpcode() == MSG_MOVE_HEARTBEAT &&
+            getMSTimeDiff(movement.farSentTime, now) < farInterval)
+        {
+            notifier.i_dist = farDistance;
+            radius = farDistance;
+        }
+        else
+        {
+            movement.farSentTime = now;
+
+            if (movement.packet.GetOpcode() == MSG_MOVE_HEARTBEAT)
+            {
+                notifier.i_congestedDist = farDistance;
+            }
+        }
+
+        Cell::VisitWorldObjects(mover, notifier, radius);
+        ++itr;
+    }
+}
+
 /**
  * @brief Builds and sends pending object update packets to affected players.
  */
@@ -2812,8 +3134,17 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+    CollisionProfileScope profileScope(COLLISION_QUERY_LOS);
+
+    bool staticLos = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ);
+
+    if (sCollisionProfiler.IsCapturing())
+    {
+        CollisionQueryRecord rec = { COLLISION_QUERY_LOS, GetId(), srcX, srcY, srcZ, destX, destY, destZ, 0.0f, staticLos, 0.0f, 0, 0, 0, 0 };
+        sCollisionProfiler.Capture(rec);
+    }
+
+    return staticLos && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
 }
 
 /**
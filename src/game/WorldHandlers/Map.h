@@ -68,6 +68,8 @@
 #include "ScriptMgr.h"
 #include "CreatureLinkingMgr.h"
 #include "DynamicTree.h"
+#include "PathCache.h"
+#include "WorldPacket.h"
 #ifdef ENABLE_ELUNA
 #include "LuaValue.h"
 #endif /* ENABLE_ELUNA */
@@ -178,6 +180,8 @@ class Map : public GridRefManager<NGridType>
 
         void MessageBroadcast(Player const*, WorldPacket*, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket*);
+        void MessageBroadcast(WorldObject const*, WorldPacket*, GuidSet const& skipped);
+        void CosmeticMessageBroadcast(WorldObject const*, WorldPacket*);
         void MessageDistBroadcast(Player const*, WorldPacket*, float dist, bool to_self, bool own_team_only = false);
         void MessageDistBroadcast(WorldObject const*, WorldPacket*, float dist);
 
@@ -331,6 +335,10 @@ class Map : public GridRefManager<NGridType>
             i_objectsToClientUpdate.erase(obj);
         }
 
+        bool DeferSplineLaunch(Unit const* unit);
+        void OnSplineSentInCreate(Unit const* unit, Player const* receiver);
+        void BroadcastMovement(Unit const* mover, Player const* controller, WorldPacket& data);
+
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
 
@@ -349,6 +357,7 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(float x, float y, float z) const;
         bool GetHeightInRange(float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const;
+        PathCache& GetPathCache() { return m_pathCache; }
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
@@ -395,6 +404,7 @@ class Map : public GridRefManager<NGridType>
         void SendRemoveTransports(Player* player);
 
         bool CreatureCellRelocation(Creature* creature, const Cell &new_cell);
+        void PreloadGridAhead(Player* player, float dx, float dy);
 
         bool loaded(const GridPair&) const;
         void EnsureGridCreated(const GridPair&);
@@ -419,6 +429,32 @@ class Map : public GridRefManager<NGridType>
         void SendObjectUpdates();
         std::set<Object*> i_objectsToClientUpdate;
 
+        void SendSplineLaunches();
+        struct PendingSplineLaunch
+        {
+            PendingSplineLaunch() : splineId(0) {}
+
+            uint32 splineId;                                // last spline launched in this update
+            std::map<ObjectGuid, uint32> createdFor;        // receivers of a create block -> spline id it carried
+        };
+        typedef std::map<ObjectGuid, PendingSplineLaunch> PendingSplineLaunches;   // unit guid -> launch
+        PendingSplineLaunches i_pendingSplineLaunches;
+        bool m_updating;                                    // inside Update(), spline launches are deferred
+
+        void SendMovements();
+        struct PendingMovement
+        {
+            PendingMovement() : pending(false), farSentTime(0), x(0.0f), y(0.0f), z(0.0f) {}
+
+            WorldPacket packet;                             // last coalesced movement packet of the mover
+            ObjectGuid controller;                          // player that sent it, does not receive it back
+            bool pending;                                   // packet not sent yet
+            uint32 farSentTime;                             // last time far observers got a heartbeat
+            float x, y, z;                                  // mover position the packet was built at
+        };
+        typedef std::map<ObjectGuid, PendingMovement> PendingMovements;   // mover guid -> coalesced movement
+        PendingMovements i_pendingMovements;
+
     protected:
         MapEntry const* i_mapEntry;
         uint8 i_spawnMode;
@@ -446,6 +482,7 @@ class Map : public GridRefManager<NGridType>
         // Shared geodata object with map coord info...
         TerrainInfo* const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        bool m_bPreloadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];    // terrain files already queued for read-ahead
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
@@ -473,6 +510,7 @@ class Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+        PathCache m_pathCache;                              // recently found navmesh corridors
 
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
@@ -104,6 +104,12 @@ MapManager::Initialize()
         abort();
     }
 
+    // Start the terrain read-ahead thread if needed.
+    if (sWorld.getConfig(CONFIG_UINT32_GRID_PRELOAD_TIME) && m_preloader.activate() == -1)
+    {
+        sLog.outError("MapManager::Initialize: Failed to start the grid preloader, grids will be loaded without read-ahead.");
+    }
+
     InitStateMachine();
     InitMaxInstanceId();
 }
@@ -390,6 +396,11 @@ void MapManager::UnloadAll()
         m_updater.deactivate();
         sLog.outString("[shutdown] MapManager::UnloadAll: MapUpdater deactivated");
     }
+
+    if (m_preloader.activated())
+    {
+        m_preloader.deactivate();
+    }
 }
 
 /**
@@ -32,6 +32,7 @@
 #include "Map.h"
 #include "GridStates.h"
 #include "MapUpdater.h"
+#include "GridPreloader.h"
 
 class Transport;
 class BattleGround;
@@ -101,6 +102,17 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         void UnloadAll();
 
+        /**
+         * @brief Queues the terrain files of a grid to be read ahead of its loading.
+         *
+         * @param mapId Id of the map the grid belongs to.
+         * @param gx Terrain grid X coordinate.
+         * @param gy Terrain grid Y coordinate.
+         * @return true if the grid was queued.
+         */
+        bool ScheduleGridPreload(uint32 mapId, uint32 gx, uint32 gy) { return m_preloader.schedule_preload(mapId, gx, gy); }
+        GridPreloader const& GetGridPreloader() const { return m_preloader; }
+
         static bool ExistMapAndVMap(uint32 mapid, float x, float y);
         static bool IsValidMAP(uint32 mapid);
 
@@ -198,6 +210,7 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         MapMapType i_maps;
         IntervalTimer i_timer;
         MapUpdater m_updater;
+        GridPreloader m_preloader;
         uint32 i_MaxInstanceId;
 
         typedef ACE_Recursive_Thread_Mutex LOCK_TYPE;
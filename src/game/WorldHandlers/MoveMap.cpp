@@ -31,6 +31,7 @@
  *
  * Features:
  * - Navigation mesh loading and management per map tile
+ * - Memory budget with least recently used tile eviction
  * - Pathfinding query interface for units
  * - Configurable pathfinding per map/unit type
  * - Height and slope limit validation
@@ -48,6 +49,12 @@
 #include "Creature.h"
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
+#include "GameTime.h"
+#include "Timer.h"
+
+#include <ace/Atomic_Op.h>
+#include <ace/Guard_T.h>
+#include <algorithm>
 
 namespace MMAP
 {
@@ -218,6 +225,17 @@ namespace MMAP
     }
 
     // ######################## MMapManager ########################
+
+    /**
+     * @brief Returns a small id of the calling thread, used to give every thread its own dtNavMeshQuery.
+     */
+    static uint32 GetQueryThreadId()
+    {
+        static ACE_Atomic_Op<ACE_Thread_Mutex, uint32> threadCount;
+        static thread_local uint32 threadId = ++threadCount;
+        return threadId;
+    }
+
     MMapManager::~MMapManager()
     {
         for (MMapDataSet::iterator i = loadedMMaps.begin(); i != loadedMMaps.end(); ++i)
@@ -231,6 +249,8 @@ namespace MMAP
 
     bool MMapManager::loadMapData(uint32 mapId)
     {
+        ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, false);
+
         // we already have this map loaded?
         if (loadedMMaps.find(mapId) != loadedMMaps.end())
         {
@@ -292,26 +312,60 @@ namespace MMAP
         return uint32(x << 16 | y);
     }
 
+    /**
+     * @brief Loads the navmesh tile of a map grid.
+     * @param mapId Map ID of the grid
+     * @param x Grid X coordinate
+     * @param y Grid Y coordinate
+     * @return true if the tile was loaded or deferred
+     *
+     * Waits for running path queries on the navmesh. A grid loaded lazily
+     * by a path query of the calling thread (terrain lookups while a path is
+     * built) would wait for itself, its tile is deferred instead and loaded
+     * by the next path query that needs it.
+     */
     bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
     {
-        // make sure the mmap is loaded and ready to load tiles
-        if (!loadMapData(mapId))
+        ACE_RW_Thread_Mutex* queryLock;
         {
-            return false;
-        }
+            ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, false);
 
-        // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
-        MANGOS_ASSERT(mmap->navMesh);
+            // make sure the mmap is loaded and ready to load tiles
+            if (!loadMapData(mapId))
+            {
+                return false;
+            }
 
-        // check if we already have this tile loaded
-        uint32 packedGridPos = packTileID(x, y);
-        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
-        {
-            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %04u%02i%02i.mmtile", mapId, x, y);
-            return false;
+            MMapData* mmap = loadedMMaps[mapId];
+            MANGOS_ASSERT(mmap->navMesh);
+
+            if (NavMeshReadGuard::IsHeld())
+            {
+                return deferTile(mapId, mmap, x, y);
+            }
+
+            queryLock = &mmap->queryLock;
         }
 
+        // the query lock is taken before m_lock, like path queries do. The navmesh
+        // data is only deleted with the terrain, which is not loading grids then.
+        ACE_Write_Guard<ACE_RW_Thread_Mutex> queryGuard(*queryLock);
+        ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, false);
+
+        return loadTile(mapId, loadedMMaps[mapId], x, y);
+    }
+
+    /**
+     * @brief Reads the navmesh tile file of a map grid.
+     * @param mapId Map ID of the grid
+     * @param x Grid X coordinate
+     * @param y Grid Y coordinate
+     * @param data Receives the tile data, allocated with dtAlloc
+     * @param dataSize Receives the size of the tile data
+     * @return true if the tile was read
+     */
+    bool MMapManager::readTile(uint32 mapId, int32 x, int32 y, unsigned char*& data, uint32& dataSize)
+    {
         // MMap tile files follow the same swapped grid order as VMap tiles.
         const int32 filenameTileX = y;
         const int32 filenameTileY = x;
@@ -365,7 +419,7 @@ namespace MMAP
             return false;
         }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+        data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
         MANGOS_ASSERT(data);
 
         size_t result = fread(data, fileHeader.size, 1, file);
@@ -374,82 +428,282 @@ namespace MMAP
             sLog.outError("MMAP:loadMap: Bad header or data in mmap "
                           "%04u%02i%02i.mmtile",
                           mapId, filenameTileX, filenameTileY);
+            dtFree(data);
             fclose(file);
             return false;
         }
 
         fclose(file);
 
+        dataSize = fileHeader.size;
+        return true;
+    }
+
+    /**
+     * @brief Adds the navmesh tile of a map grid to the navmesh.
+     * @param mapId Map ID of the grid
+     * @param mmap Navmesh data of the map
+     * @param x Grid X coordinate
+     * @param y Grid Y coordinate
+     * @return true if the tile was loaded
+     *
+     * @note The caller holds m_lock and the query lock of the map for writing
+     */
+    bool MMapManager::loadTile(uint32 mapId, MMapData* mmap, int32 x, int32 y)
+    {
+        // check if we already have this tile loaded
+        uint32 packedGridPos = packTileID(x, y);
+        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
+        {
+            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %04u%02i%02i.mmtile", mapId, x, y);
+            return false;
+        }
+
+        unsigned char* data;
+        uint32 dataSize;
+        if (!readTile(mapId, x, y, data, dataSize))
+        {
+            return false;
+        }
+
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
+        uint32 navTileId = packTileID(header->x, header->y);
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        dtStatus dtResult = mmap->navMesh->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, &tileRef);
         if (dtStatusFailed(dtResult))
         {
             sLog.outError("MMAP:loadMap: Could not load "
                           "%04u%02i%02i.mmtile into navmesh",
-                          mapId, filenameTileX, filenameTileY);
+                          mapId, y, x);
             dtFree(data);
             return false;
         }
 
-        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        mmap->mmapLoadedTiles.insert(std::pair<uint32, MMapTile>(packedGridPos, MMapTile(tileRef, dataSize, navTileId, GameTime::GetGameTimeMS())));
+        mmap->navTiles[navTileId] = packedGridPos;
+        mmap->evictedTiles.erase(navTileId);
         ++loadedTiles;
+        residentBytes += dataSize;
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING,
                          "MMAP:loadMap: Loaded mmtile "
                          "%04u[%02i,%02i] into %04u[%02i,%02i]",
-                         mapId, filenameTileX, filenameTileY, mapId,
+                         mapId, y, x, mapId,
                          header->x, header->y);
+
+        evictTiles(mmap);
         return true;
     }
 
-    bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
+    /**
+     * @brief Registers the navmesh tile of a map grid without adding it to the navmesh.
+     * @param mapId Map ID of the grid
+     * @param mmap Navmesh data of the map
+     * @param x Grid X coordinate
+     * @param y Grid Y coordinate
+     * @return true if the tile was registered
+     *
+     * The tile is kept like an evicted one, acquireTiles() adds it once a
+     * path query needs it. Only the tile header is used, the file is read
+     * again then.
+     *
+     * @note The caller holds m_lock
+     */
+    bool MMapManager::deferTile(uint32 mapId, MMapData* mmap, int32 x, int32 y)
     {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        uint32 packedGridPos = packTileID(x, y);
+        if (mmap->mmapLoadedTiles.find(packedGridPos) != mmap->mmapLoadedTiles.end())
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map. %04u%02i%02i.mmtile", mapId, x, y);
+            sLog.outError("MMAP:loadMap: Asked to load already loaded navmesh tile. %04u%02i%02i.mmtile", mapId, x, y);
+            return false;
+        }
+
+        unsigned char* data;
+        uint32 dataSize;
+        if (!readTile(mapId, x, y, data, dataSize))
+        {
+            return false;
+        }
+
+        dtMeshHeader* header = (dtMeshHeader*)data;
+        mmap->evictedTiles[packTileID(header->x, header->y)] = packedGridPos;
+        dtFree(data);
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Deferred mmtile %04u[%02i,%02i] until a path query needs it", mapId, y, x);
+        return true;
+    }
+
+    /**
+     * @brief Removes a loaded tile from the navmesh of a map.
+     * @param mapId Map ID of the tile
+     * @param mmap Navmesh data of the map
+     * @param packedGridPos Packed grid coordinates of the tile
+     * @return true if the tile was removed
+     */
+    bool MMapManager::removeTile(uint32 mapId, MMapData* mmap, uint32 packedGridPos)
+    {
+        MMapTileSet::iterator itr = mmap->mmapLoadedTiles.find(packedGridPos);
+        uint32 x = (packedGridPos >> 16);
+        uint32 y = (packedGridPos & 0x0000FFFF);
+
+        dtStatus dtResult = mmap->navMesh->removeTile(itr->second.tileRef, NULL, NULL);
+        if (dtStatusFailed(dtResult))
+        {
+            sLog.outError("MMAP:removeTile: Could not unload %04u%02u%02u.mmtile from navmesh", mapId, x, y);
             return false;
         }
 
+        --loadedTiles;
+        residentBytes -= itr->second.dataSize;
+        mmap->navTiles.erase(itr->second.navTileId);
+        mmap->mmapLoadedTiles.erase(itr);
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:removeTile: Unloaded mmtile %04u[%02u,%02u] from %04u", mapId, x, y, mapId);
+        return true;
+    }
+
+    /**
+     * @brief Evicts least recently used tiles until the tile data fits into mmap.memoryBudget.
+     * @param lockedMap Navmesh whose query lock the caller holds for writing
+     *
+     * Tiles used by a path query in the current world tick, which includes
+     * the tiles just loaded, are kept. Other navmeshes with a running path
+     * query are skipped until the next tile load. Evicted tiles stay
+     * registered with their grid and are reloaded by acquireTiles() once a
+     * path query needs them again.
+     */
+    void MMapManager::evictTiles(MMapData* lockedMap)
+    {
+        uint64 budget = uint64(sWorld.getConfig(CONFIG_UINT32_MMAP_MEMORY_BUDGET)) * 1024 * 1024;
+        if (!budget || residentBytes <= budget)
+        {
+            return;
+        }
+
+        struct Candidate
+        {
+            uint32 idleTime;
+            uint32 mapId;
+            MMapData* mmap;
+            uint32 packedGridPos;
+
+            bool operator < (const Candidate& other) const { return idleTime > other.idleTime; }
+        };
+
+        uint32 now = GameTime::GetGameTimeMS();
+        std::vector<MMapData*> lockedMaps;
+        std::vector<Candidate> candidates;
+        for (MMapDataSet::iterator i = loadedMMaps.begin(); i != loadedMMaps.end(); ++i)
+        {
+            if (i->second != lockedMap)
+            {
+                // a path query is running on this navmesh, do not pull tiles from under it
+                if (i->second->queryLock.tryacquire_write() != 0)
+                {
+                    continue;
+                }
+
+                lockedMaps.push_back(i->second);
+            }
+
+            for (MMapTileSet::const_iterator tile = i->second->mmapLoadedTiles.begin(); tile != i->second->mmapLoadedTiles.end(); ++tile)
+            {
+                if (tile->second.lastUsed == now)
+                {
+                    continue;
+                }
+
+                Candidate candidate = { getMSTimeDiff(tile->second.lastUsed, now), i->first, i->second, tile->first };
+                candidates.push_back(candidate);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        for (std::vector<Candidate>::const_iterator i = candidates.begin(); i != candidates.end() && residentBytes > budget; ++i)
+        {
+            uint32 navTileId = i->mmap->mmapLoadedTiles.find(i->packedGridPos)->second.navTileId;
+            if (removeTile(i->mapId, i->mmap, i->packedGridPos))
+            {
+                i->mmap->evictedTiles[navTileId] = i->packedGridPos;
+                ++evictedTilesCount;
+            }
+        }
+
+        for (std::vector<MMapData*>::const_iterator i = lockedMaps.begin(); i != lockedMaps.end(); ++i)
+        {
+            (*i)->queryLock.release();
+        }
+    }
+
+    /**
+     * @brief Unloads the navmesh tile of a map grid, waiting for running path queries on the navmesh.
+     * @param mapId Map ID of the grid
+     * @param x Grid X coordinate
+     * @param y Grid Y coordinate
+     * @return true if the tile was unloaded or forgotten
+     */
+    bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
+    {
+        // grids are unloaded by the terrain manager, never while building a path
+        MANGOS_ASSERT(!NavMeshReadGuard::IsHeld());
+
+        ACE_RW_Thread_Mutex* queryLock;
+        {
+            ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, false);
+
+            // check if we have this map loaded
+            MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+            if (itr == loadedMMaps.end())
+            {
+                // file may not exist, therefore not loaded
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map. %04u%02i%02i.mmtile", mapId, x, y);
+                return false;
+            }
+
+            queryLock = &itr->second->queryLock;
+        }
+
+        // the query lock is taken before m_lock, like path queries do
+        ACE_Write_Guard<ACE_RW_Thread_Mutex> queryGuard(*queryLock);
+        ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, false);
+
         MMapData* mmap = loadedMMaps[mapId];
 
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
         if (mmap->mmapLoadedTiles.find(packedGridPos) == mmap->mmapLoadedTiles.end())
         {
+            // the tile may have been evicted or deferred, the grid is gone now so it must not come back
+            for (MMapNavTileSet::iterator i = mmap->evictedTiles.begin(); i != mmap->evictedTiles.end(); ++i)
+            {
+                if (i->second == packedGridPos)
+                {
+                    mmap->evictedTiles.erase(i);
+                    return true;
+                }
+            }
+
             // file may not exist, therefore not loaded
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh tile. %04u%02i%02i.mmtile", mapId, x, y);
             return false;
         }
 
-        dtTileRef tileRef = mmap->mmapLoadedTiles[packedGridPos];
-
         // unload, and mark as non loaded
-        dtStatus dtResult = mmap->navMesh->removeTile(tileRef, NULL, NULL);
-        if (dtStatusFailed(dtResult))
+        if (!removeTile(mapId, mmap, packedGridPos))
         {
             // this is technically a memory leak
             // if the grid is later reloaded, dtNavMesh::addTile will return error but no extra memory is used
             // we can not recover from this error - assert out
-            sLog.outError("MMAP:unloadMap: Could not unload %04u%02i%02i.mmtile from navmesh", mapId, x, y);
             MANGOS_ASSERT(false);
         }
-        else
-        {
-            mmap->mmapLoadedTiles.erase(packedGridPos);
-            --loadedTiles;
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %04u[%02i,%02i] from %04u", mapId, x, y, mapId);
-            return true;
-        }
 
-        return false;
+        return true;
     }
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
+        ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, false);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
             // file may not exist, therefore not loaded
@@ -459,19 +713,15 @@ namespace MMAP
 
         // unload all tiles from given map
         MMapData* mmap = loadedMMaps[mapId];
-        for (MMapTileSet::iterator i = mmap->mmapLoadedTiles.begin(); i != mmap->mmapLoadedTiles.end(); ++i)
+        while (!mmap->mmapLoadedTiles.empty())
         {
-            uint32 x = (i->first >> 16);
-            uint32 y = (i->first & 0x0000FFFF);
-            dtStatus dtResult = mmap->navMesh->removeTile(i->second, NULL, NULL);
-            if (dtStatusFailed(dtResult))
-            {
-                sLog.outError("MMAP:unloadMap: Could not unload %04u%02u%02u.mmtile from navmesh", mapId, x, y);
-            }
-            else
+            uint32 packedGridPos = mmap->mmapLoadedTiles.begin()->first;
+            if (!removeTile(mapId, mmap, packedGridPos))
             {
+                // the navmesh frees the tile data along with itself, only our bookkeeping is left
                 --loadedTiles;
-                    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %04u[%02u,%02u] from %04u", mapId, x, y, mapId);
+                residentBytes -= mmap->mmapLoadedTiles.begin()->second.dataSize;
+                mmap->mmapLoadedTiles.erase(mmap->mmapLoadedTiles.begin());
             }
         }
 
@@ -482,67 +732,182 @@ namespace MMAP
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
+    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        // check if we have this map loaded
+        ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, NULL);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %04u", mapId);
-            return false;
+            return NULL;
+        }
+
+        return loadedMMaps[mapId]->navMesh;
+    }
+
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
+    {
+        ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, NULL);
+
+        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        {
+            return NULL;
         }
 
         MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        uint32 threadId = GetQueryThreadId();
+        NavMeshQuerySet::const_iterator itr = mmap->navMeshQueries.find(threadId);
+        if (itr != mmap->navMeshQueries.end())
         {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %04u instanceId %u", mapId, instanceId);
-            return false;
+            return itr->second;
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        dtStatus dtResult = query->init(mmap->navMesh, 1024);
+        if (dtStatusFailed(dtResult))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %04u thread %u", mapId, threadId);
+            return NULL;
+        }
 
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %04u instanceId %u", mapId, instanceId);
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %04u thread %u", mapId, threadId);
+        mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(threadId, query));
+        return query;
+    }
 
-        return true;
+    ACE_RW_Thread_Mutex* MMapManager::GetQueryLock(uint32 mapId)
+    {
+        ACE_GUARD_RETURN(LOCK_TYPE, guard, m_lock, NULL);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        return itr != loadedMMaps.end() ? &itr->second->queryLock : NULL;
     }
 
-    dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
+    /**
+     * @brief Marks the navmesh tiles of an area as used by a path query
+     * @param mapId Map ID of the navmesh
+     * @param minTileX Lowest navmesh tile X coordinate
+     * @param minTileY Lowest navmesh tile Y coordinate
+     * @param maxTileX Highest navmesh tile X coordinate
+     * @param maxTileY Highest navmesh tile Y coordinate
+     *
+     * Called with the tiles between the start and the end of a path, so the
+     * tiles in the middle of a corridor age like its ends. Tiles evicted to
+     * stay within mmap.memoryBudget, or deferred while a grid loaded during
+     * a path query, are loaded again, unless a path query is running on the
+     * navmesh. Then they are reloaded by a later query.
+     *
+     * @note Must not be called while holding the query lock of the map
+     */
+    void MMapManager::acquireTiles(uint32 mapId, int32 minTileX, int32 minTileY, int32 maxTileX, int32 maxTileY)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        ACE_GUARD(LOCK_TYPE, guard, m_lock);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
         {
-            return NULL;
+            return;
         }
 
-        return loadedMMaps[mapId]->navMesh;
+        MMapData* mmap = itr->second;
+        uint32 now = GameTime::GetGameTimeMS();
+        bool locked = false;
+
+        for (int32 tileX = minTileX; tileX <= maxTileX; ++tileX)
+        {
+            for (int32 tileY = minTileY; tileY <= maxTileY; ++tileY)
+            {
+                uint32 navTileId = packTileID(tileX, tileY);
+                MMapNavTileSet::const_iterator loaded = mmap->navTiles.find(navTileId);
+                if (loaded != mmap->navTiles.end())
+                {
+                    mmap->mmapLoadedTiles.find(loaded->second)->second.lastUsed = now;
+                    ++tileHits;
+                    continue;
+                }
+
+                // not evicted - the grid is not loaded or has no navmesh
+                MMapNavTileSet::const_iterator evicted = mmap->evictedTiles.find(navTileId);
+                if (evicted == mmap->evictedTiles.end())
+                {
+                    continue;
+                }
+
+                if (!locked)
+                {
+                    if (mmap->queryLock.tryacquire_write() != 0)
+                    {
+                        continue;
+                    }
+
+                    locked = true;
+                }
+
+                uint32 packedGridPos = evicted->second;
+                ++tileMisses;
+                loadTile(mapId, mmap, int32(packedGridPos >> 16), int32(packedGridPos & 0x0000FFFF));
+            }
+        }
+
+        if (locked)
+        {
+            mmap->queryLock.release();
+        }
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    /**
+     * @brief Marks navmesh tiles as used by a path query
+     * @param mapId Map ID of the navmesh
+     * @param tiles Navmesh tile coordinates
+     *
+     * Used for the tiles a corridor crossed outside the area passed to
+     * acquireTiles(). Tiles are not reloaded, so it may be called while
+     * holding the query lock of the map.
+     */
+    void MMapManager::touchTiles(uint32 mapId, std::vector<std::pair<int32, int32> > const& tiles)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        ACE_GUARD(LOCK_TYPE, guard, m_lock);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
         {
-            return NULL;
+            return;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        MMapData* mmap = itr->second;
+        uint32 now = GameTime::GetGameTimeMS();
+
+        for (std::vector<std::pair<int32, int32> >::const_iterator tile = tiles.begin(); tile != tiles.end(); ++tile)
         {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            dtStatus dtResult = query->init(mmap->navMesh, 1024);
-            if (dtStatusFailed(dtResult))
+            MMapNavTileSet::const_iterator loaded = mmap->navTiles.find(packTileID(tile->first, tile->second));
+            if (loaded != mmap->navTiles.end())
             {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %04u instanceId %u", mapId, instanceId);
-                return NULL;
+                mmap->mmapLoadedTiles.find(loaded->second)->second.lastUsed = now;
             }
-
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %04u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
         }
+    }
 
-        return mmap->navMeshQueries[instanceId];
+    // ######################## NavMeshReadGuard ########################
+
+    /// number of navmesh query locks the calling thread holds for reading
+    static thread_local uint32 heldQueryLocks = 0;
+
+    NavMeshReadGuard::NavMeshReadGuard(ACE_RW_Thread_Mutex& lock) : m_lock(lock)
+    {
+        m_lock.acquire_read();
+        ++heldQueryLocks;
+    }
+
+    NavMeshReadGuard::~NavMeshReadGuard()
+    {
+        --heldQueryLocks;
+        m_lock.release();
+    }
+
+    bool NavMeshReadGuard::IsHeld()
+    {
+        return heldQueryLocks != 0;
     }
 }
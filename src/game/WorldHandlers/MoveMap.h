@@ -32,6 +32,11 @@
 #include "Platform/Define.h"
 #include "Utilities/UnorderedMapSet.h"
 
+#include <ace/Recursive_Thread_Mutex.h>
+#include <ace/RW_Thread_Mutex.h>
+
+#include <vector>
+
 class Unit;
 
 //  memory management
@@ -48,7 +53,20 @@ inline void dtCustomFree(void* ptr)
 //  move map related classes
 namespace MMAP
 {
-    typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
+    // a navmesh tile loaded for a map grid
+    struct MMapTile
+    {
+        MMapTile(dtTileRef ref, uint32 size, uint32 navTile, uint32 now) :
+            tileRef(ref), dataSize(size), navTileId(navTile), lastUsed(now) {}
+
+        dtTileRef tileRef;
+        uint32 dataSize;                    // bytes of tile data owned by detour
+        uint32 navTileId;                   // packed navmesh tile coordinates
+        uint32 lastUsed;                    // game time of the last path query on the tile
+    };
+
+    typedef UNORDERED_MAP<uint32, MMapTile> MMapTileSet;
+    typedef UNORDERED_MAP<uint32, uint32> MMapNavTileSet;
     typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
@@ -70,9 +88,28 @@ namespace MMAP
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // dtNavMeshQuery is not thread safe, every thread that searches paths on this map gets its own
+        NavMeshQuerySet navMeshQueries;     // query thread id to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        MMapNavTileSet navTiles;            // maps [navmesh tile coords] of loaded tiles to [map grid coords]
+        MMapNavTileSet evictedTiles;        // maps [navmesh tile coords] of evicted tiles to [map grid coords]
+
+        // path queries hold it for reading, tiles are only added or removed while it is held for writing
+        ACE_RW_Thread_Mutex queryLock;
+    };
+
+    // holds the query lock of a navmesh for reading while a path is built
+    class NavMeshReadGuard
+    {
+        public:
+            explicit NavMeshReadGuard(ACE_RW_Thread_Mutex& lock);
+            ~NavMeshReadGuard();
+
+            // does the calling thread hold the query lock of any navmesh?
+            static bool IsHeld();
+
+        private:
+            ACE_RW_Thread_Mutex& m_lock;
     };
 
 
@@ -83,26 +120,49 @@ namespace MMAP
     class MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0) {}
+            MMapManager() : loadedTiles(0), residentBytes(0), tileHits(0), tileMisses(0), evictedTilesCount(0) {}
             ~MMapManager();
 
             bool loadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the returned [dtNavMeshQuery const*] belongs to the calling thread, do not pass it to other threads
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            // hold it for reading (NavMeshReadGuard) while querying the navmesh of the map
+            ACE_RW_Thread_Mutex* GetQueryLock(uint32 mapId);
+            // marks the navmesh tiles of an area as used by a path query, reloads the evicted ones
+            void acquireTiles(uint32 mapId, int32 minTileX, int32 minTileY, int32 maxTileX, int32 maxTileY);
+            // marks navmesh tiles as used by a path query, may be called while holding the query lock
+            void touchTiles(uint32 mapId, std::vector<std::pair<int32, int32> > const& tiles);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+            uint64 getResidentBytes() const { return residentBytes; }
+            uint64 getTileHits() const { return tileHits; }
+            uint64 getTileMisses() const { return tileMisses; }
+            uint64 getEvictedTilesCount() const { return evictedTilesCount; }
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
+            bool readTile(uint32 mapId, int32 x, int32 y, unsigned char*& data, uint32& dataSize);
+            bool loadTile(uint32 mapId, MMapData* mmap, int32 x, int32 y);
+            bool deferTile(uint32 mapId, MMapData* mmap, int32 x, int32 y);
+            bool removeTile(uint32 mapId, MMapData* mmap, uint32 packedGridPos);
+            void evictTiles(MMapData* lockedMap);
 
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
+            uint64 residentBytes;               // tile data of all navmeshes
+            uint64 tileHits;                    // path queries finding their tiles loaded
+            uint64 tileMisses;                  // path queries reloading an evicted or deferred tile
+            uint64 evictedTilesCount;           // tiles evicted to stay within mmap.memoryBudget
+
+            // maps of several map instances are updated by different threads at once
+            typedef ACE_Recursive_Thread_Mutex LOCK_TYPE;
+            LOCK_TYPE m_lock;                   // guards loadedMMaps and the tile and query sets
     };
 
     // static class
@@ -412,6 +412,13 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
         plMover->HandleFall(movementInfo);
     }
 
+    // a facing change that does not change anything is not worth sending
+    Position const* pos = movementInfo.GetPos();
+    bool unchanged = opcode == MSG_MOVE_SET_FACING && !movementInfo.HasMovementFlag(MOVEFLAG_ONTRANSPORT) &&
+                     movementInfo.GetMovementFlags() == mover->m_movementInfo.GetMovementFlags() &&
+                     pos->x == mover->GetPositionX() && pos->y == mover->GetPositionY() &&
+                     pos->z == mover->GetPositionZ() && pos->o == mover->GetOrientation();
+
     /* process position-change */
     HandleMoverRelocation(movementInfo);
 
@@ -420,10 +427,15 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
         plMover->UpdateFallInformationIfNeed(movementInfo, opcode);
     }
 
+    if (unchanged || !mover->IsInWorld())
+    {
+        return;
+    }
+
     WorldPacket data(opcode, recv_data.size());
     data << mover->GetPackGUID();             // write guid
     movementInfo.Write(data);                               // write data
-    mover->SendMessageToSetExcept(&data, _player);
+    mover->GetMap()->BroadcastMovement(mover, _player, data);
 }
 
 /**
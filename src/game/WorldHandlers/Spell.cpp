@@ -71,6 +71,7 @@
 #include "Chat.h"
 #include "SQLStorages.h"
 #include "DisableMgr.h"
+#include "SpellProfiler.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
@@ -323,6 +324,151 @@ void SpellCastTargets::read(ByteBuffer& data, Unit* caster)
     Update(caster);
 }
 
+#define SPELL_POOL_MAX_FREE 256                             // per thread, bounds memory kept after a burst
+#define SPELL_POOL_MAX_NODES 1024                           // per thread and target list type
+
+/**
+ * @brief Recycles the memory of finished Spell objects and their target lists.
+ *
+ * Every map update thread gets its own free list, so instant casts, procs
+ * and triggered spells reuse memory without touching the global allocator
+ * and without locking. A Spell deleted on another thread than it was created
+ * on simply moves its block to that thread's list. The nodes of the unique
+ * target lists are kept the same way and spliced into the next cast's lists.
+ */
+struct SpellPool
+{
+    ~SpellPool()
+    {
+        for (std::vector<void*>::const_iterator itr = freeBlocks.begin(); itr != freeBlocks.end(); ++itr)
+        {
+            ::operator delete(*itr);
+        }
+    }
+
+    std::vector<void*> freeBlocks;
+    Spell::TargetList freeTargets;
+    Spell::GOTargetList freeGOTargets;
+    Spell::ItemTargetList freeItemTargets;
+};
+
+// Spells may still be freed while the thread's destructors run, the pool is heap allocated and
+// reached through trivially destructible thread locals, which stay readable until the thread ends
+static thread_local SpellPool* t_spellPool = NULL;
+static thread_local bool t_spellPoolClosed = false;
+
+/**
+ * @brief Frees the thread's pool when the thread ends.
+ */
+struct SpellPoolCloser
+{
+    ~SpellPoolCloser()
+    {
+        delete t_spellPool;
+        t_spellPool = NULL;
+        t_spellPoolClosed = true;
+    }
+};
+
+/**
+ * @brief Returns the pool of the calling thread.
+ *
+ * @return The pool, or NULL once the thread is ending.
+ */
+static SpellPool* GetSpellPool()
+{
+    if (!t_spellPool && !t_spellPoolClosed)
+    {
+        static thread_local SpellPoolCloser closer;
+        t_spellPool = new SpellPool();
+    }
+
+    return t_spellPool;
+}
+
+/**
+ * @brief Appends a value, reusing a node of the thread's pool if possible.
+ *
+ * @param list The list to append to.
+ * @param freeNodes The pool's spare nodes of the list type.
+ * @param value The value to append.
+ */
+template<class T>
+static void PushPooled(std::list<T>& list, std::list<T> SpellPool::* freeNodes, T const& value)
+{
+    SpellPool* pool = GetSpellPool();
+    if (!pool || (pool->*freeNodes).empty())
+    {
+        list.push_back(value);
+        return;
+    }
+
+    list.splice(list.end(), pool->*freeNodes, (pool->*freeNodes).begin());
+    list.back() = value;
+}
+
+/**
+ * @brief Empties a list, keeping its nodes in the thread's pool.
+ *
+ * @param list The list to empty.
+ * @param freeNodes The pool's spare nodes of the list type.
+ */
+template<class T>
+static void ReleasePooled(std::list<T>& list, std::list<T> SpellPool::* freeNodes)
+{
+    SpellPool* pool = GetSpellPool();
+    if (!pool || (pool->*freeNodes).size() + list.size() > SPELL_POOL_MAX_NODES)
+    {
+        list.clear();
+        return;
+    }
+
+    (pool->*freeNodes).splice((pool->*freeNodes).end(), list);
+}
+
+/**
+ * @brief Allocates a Spell, reusing a block of the thread's pool if possible.
+ *
+ * @param size The requested size.
+ * @return The allocated memory.
+ */
+void* Spell::operator new(size_t size)
+{
+    SpellPool* pool = GetSpellPool();
+    if (pool && size == sizeof(Spell) && !pool->freeBlocks.empty())
+    {
+        void* ptr = pool->freeBlocks.back();
+        pool->freeBlocks.pop_back();
+        sSpellProfiler.OnSpellRecycled();
+        return ptr;
+    }
+
+    return ::operator new(size);
+}
+
+/**
+ * @brief Returns a Spell's memory to the thread's pool.
+ *
+ * @param ptr The memory to release.
+ * @param size The size of the released object.
+ */
+void Spell::operator delete(void* ptr, size_t size)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    SpellPool* pool = GetSpellPool();
+    if (pool && size == sizeof(Spell) && pool->freeBlocks.size() < SPELL_POOL_MAX_FREE)
+    {
+        pool->freeBlocks.push_back(ptr);
+        return;
+    }
+
+    ::operator delete(ptr);
+}
+
 /**
  * @brief Serializes spell cast targets into a packet buffer.
  *
@@ -399,6 +545,8 @@ Spell::Spell(Unit* caster, SpellEntry const* info, bool triggered, ObjectGuid or
     MANGOS_ASSERT(caster != NULL && info != NULL);
     MANGOS_ASSERT(info == sSpellStore.LookupEntry(info->Id));   // `info` must be pointer to sSpellStore element
 
+    sSpellProfiler.OnSpellCreated();
+
     m_spellInfo = info;
     m_triggeredBySpellInfo = triggeredBy;
     m_caster = caster;
@@ -501,6 +649,8 @@ Spell::Spell(Unit* caster, SpellEntry const* info, bool triggered, ObjectGuid or
 
 Spell::~Spell()
 {
+    CleanupTargetList();
+    sSpellProfiler.OnSpellDeleted();
 }
 
 template<typename T>
@@ -965,9 +1115,9 @@ void Spell::prepareDataForTriggerSystem()
  */
 void Spell::CleanupTargetList()
 {
-    m_UniqueTargetInfo.clear();
-    m_UniqueGOTargetInfo.clear();
-    m_UniqueItemInfo.clear();
+    ReleasePooled(m_UniqueTargetInfo, &SpellPool::freeTargets);
+    ReleasePooled(m_UniqueGOTargetInfo, &SpellPool::freeGOTargets);
+    ReleasePooled(m_UniqueItemInfo, &SpellPool::freeItemTargets);
     m_delayMoment = 0;
 }
 
@@ -1075,7 +1225,7 @@ void Spell::AddUnitTarget(Unit* pVictim, SpellEffectIndex effIndex)
     }
 
     // Add target to list
-    m_UniqueTargetInfo.push_back(target);
+    PushPooled(m_UniqueTargetInfo, &SpellPool::freeTargets, target);
 }
 
 /**
@@ -1149,7 +1299,7 @@ void Spell::AddGOTarget(GameObject* pVictim, SpellEffectIndex effIndex)
     }
 
     // Add target to list
-    m_UniqueGOTargetInfo.push_back(target);
+    PushPooled(m_UniqueGOTargetInfo, &SpellPool::freeGOTargets, target);
 }
 
 /**
@@ -1194,7 +1344,7 @@ void Spell::AddItemTarget(Item* pitem, SpellEffectIndex effIndex)
     ItemTargetInfo target;
     target.item       = pitem;
     target.effectMask = (1 << effIndex);
-    m_UniqueItemInfo.push_back(target);
+    PushPooled(m_UniqueItemInfo, &SpellPool::freeItemTargets, target);
 }
 
 /**
@@ -3320,6 +3470,8 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
  */
 void Spell::prepare(SpellCastTargets const* targets, Aura* triggeredByAura)
 {
+    SpellProfileScope profileScope(SPELL_PROFILE_PREPARE);
+
     m_targets = *targets;
 
     m_spellState = SPELL_STATE_PREPARING;
@@ -3479,6 +3631,8 @@ void Spell::cancel()
  */
 void Spell::cast(bool skipCheck)
 {
+    SpellProfileScope profileScope(SPELL_PROFILE_CAST);
+
     SetExecutedCurrently(true);
 
     if (!m_caster->CheckAndIncreaseCastCounter())
@@ -173,7 +173,15 @@ class SpellCastTargets
             m_destY = target.m_destY;
             m_destZ = target.m_destZ;
 
-            m_strTarget = target.m_strTarget;
+            // only string targeted casts carry text, clear() keeps the capacity for them
+            if (target.m_targetMask & TARGET_FLAG_STRING)
+            {
+                m_strTarget = target.m_strTarget;
+            }
+            else
+            {
+                m_strTarget.clear();
+            }
 
             m_targetMask = target.m_targetMask;
 
@@ -381,6 +389,11 @@ class Spell
         Spell(Unit* caster, SpellEntry const* info, bool triggered, ObjectGuid originalCasterGUID = ObjectGuid(), SpellEntry const* triggeredBy = NULL);
         ~Spell();
 
+        // Spell objects and their target list nodes are recycled through per thread free lists, see SpellPool in Spell.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+        friend struct SpellPool;
+
         void prepare(SpellCastTargets const* targets, Aura* triggeredByAura = NULL);
 
         void cancel();
@@ -70,6 +70,7 @@
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
 #include "MapManager.h"
+#include "SpellProfiler.h"
 
 #define NULL_AURA_SLOT 0xFF
 
@@ -1349,10 +1350,12 @@ void Aura::TriggerSpell()
                             return;
                         }
 
-                        ThreatList const& tList = target->GetThreatManager().getThreatList();
-                        for (ThreatList::const_iterator itr = tList.begin(); itr != tList.end(); ++itr)
+                        // wiping the threat removes the reference from the threat list, walk a copy
+                        GuidVector guids;
+                        ((Creature*)target)->FillGuidsListFromThreatList(guids);
+                        for (GuidVector::const_iterator itr = guids.begin(); itr != guids.end(); ++itr)
                         {
-                            Unit* pUnit = target->GetMap()->GetUnit((*itr)->getUnitGuid());
+                            Unit* pUnit = target->GetMap()->GetUnit(*itr);
 
                             if (pUnit && target->GetThreatManager().getThreat(pUnit))
                             {
@@ -7476,6 +7479,8 @@ void Aura::HandleSchoolAbsorb(bool apply, bool Real)
  */
 void Aura::PeriodicTick()
 {
+    SpellProfileScope profileScope(SPELL_PROFILE_AURA_TICK);
+
     Unit* target = GetTarget();
     SpellEntry const* spellProto = GetSpellProto();
 
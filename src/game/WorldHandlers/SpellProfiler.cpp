@@ -0,0 +1,158 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file SpellProfiler.cpp
+ * @brief Runtime throughput and latency statistics for the spell system
+ *
+ * Collects per stage call counts, total/max durations and a log2 latency
+ * histogram for Spell::prepare, Spell::cast, periodic aura ticks and proc
+ * handling, plus Spell object allocation and pool counts. Reported by the
+ * `.debug spellprofile` command.
+ */
+
+#include "SpellProfiler.h"
+#include "Timer.h"
+#include "Policies/Singleton.h"
+
+INSTANTIATE_SINGLETON_1(SpellProfiler);
+
+static thread_local SpellProfileScope* t_currentScope = NULL;
+
+/**
+ * @brief Construct the profiler in disabled state
+ */
+SpellProfiler::SpellProfiler() : m_enabled(false), m_resetTime(0), m_allocated(0), m_recycled(0), m_live(0), m_peakLive(0)
+{
+    Reset();
+}
+
+/**
+ * @brief Account a Spell object allocation
+ */
+void SpellProfiler::OnSpellCreated()
+{
+    // Spells may be freed on another thread than they were created on, so only the global count is exact
+    int64 live = m_live.fetch_add(1, std::memory_order_relaxed) + 1;
+    int64 oldPeak = m_peakLive.load(std::memory_order_relaxed);
+    while (live > oldPeak && !m_peakLive.compare_exchange_weak(oldPeak, live, std::memory_order_relaxed))
+    {
+    }
+
+    if (IsEnabled())
+    {
+        m_allocated.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Account a Spell object deallocation
+ */
+void SpellProfiler::OnSpellDeleted()
+{
+    m_live.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Account a Spell allocation served from a thread's Spell pool
+ */
+void SpellProfiler::OnSpellRecycled()
+{
+    if (IsEnabled())
+    {
+        m_recycled.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Clear all collected data
+ *
+ * The live Spell counter and its peak are kept, they reflect the Spell
+ * pools rather than the measured period.
+ */
+void SpellProfiler::Reset()
+{
+    for (uint32 i = 0; i < MAX_SPELL_PROFILE_STAGES; ++i)
+    {
+        m_stages[i].Reset();
+    }
+
+    m_allocated.store(0, std::memory_order_relaxed);
+    m_recycled.store(0, std::memory_order_relaxed);
+    m_resetTime.store(getMSTime(), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get calls per second since last reset
+ * @param stage Measured stage
+ * @return Rate of calls
+ */
+float SpellProfiler::GetRate(SpellProfileStage stage) const
+{
+    return m_stages[stage].GetRate(GetMSTimeDiffToNow(m_resetTime.load(std::memory_order_relaxed)));
+}
+
+/**
+ * @brief Get name of a stage for reports
+ * @param stage Measured stage
+ * @return Stage name
+ */
+char const* SpellProfiler::GetStageName(SpellProfileStage stage)
+{
+    switch (stage)
+    {
+        case SPELL_PROFILE_PREPARE:     return "prepare";
+        case SPELL_PROFILE_CAST:        return "cast";
+        case SPELL_PROFILE_AURA_TICK:   return "aura tick";
+        case SPELL_PROFILE_PROC:        return "proc";
+        default:                        return "unknown";
+    }
+}
+
+/**
+ * @brief Start measuring and become the innermost scope of this thread
+ */
+void SpellProfileScope::Start()
+{
+    m_parent = t_currentScope;
+    m_nested = std::chrono::steady_clock::duration::zero();
+    t_currentScope = this;
+    m_start = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Record the self time and hand the whole duration to the enclosing scope
+ */
+void SpellProfileScope::Stop()
+{
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - m_start;
+
+    t_currentScope = m_parent;
+    if (m_parent)
+    {
+        m_parent->m_nested += elapsed;
+    }
+
+    sSpellProfiler.Record(m_stage, std::chrono::duration_cast<std::chrono::microseconds>(elapsed - m_nested).count());
+}
@@ -0,0 +1,225 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_SPELLPROFILER
+#define MANGOS_H_SPELLPROFILER
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Utilities/LatencyHistogram.h"
+
+#include <chrono>
+
+/**
+ * @brief Spell system stages measured by the SpellProfiler
+ */
+enum SpellProfileStage
+{
+    SPELL_PROFILE_PREPARE       = 0,                        ///< Spell::prepare
+    SPELL_PROFILE_CAST          = 1,                        ///< Spell::cast
+    SPELL_PROFILE_AURA_TICK     = 2,                        ///< Aura::PeriodicTick
+    SPELL_PROFILE_PROC          = 3,                        ///< Unit::ProcDamageAndSpellFor
+    MAX_SPELL_PROFILE_STAGES
+};
+
+/**
+ * @brief Measures throughput and latency of the spell system hot paths
+ *
+ * Disabled by default. When enabled, every measured call adds its self time,
+ * without the stages nested in it, to a log2 histogram per stage, so the
+ * stages add up to the time spent in the spell system. Casts per second and
+ * latency percentiles can be compared before and after changes to Spell.cpp,
+ * SpellEffects.cpp or SpellAuras.cpp, on a running server or with the
+ * spell_bench harness. Map threads record concurrently, all counters are
+ * relaxed atomics.
+ */
+class SpellProfiler
+{
+    public:
+        SpellProfiler();
+
+        /**
+         * @brief Enable or disable recording
+         * @param enabled New state
+         */
+        void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+        /**
+         * @brief Check if recording is enabled
+         * @return True if enabled
+         */
+        bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Record one measured call
+         * @param stage Measured stage
+         * @param micros Duration in microseconds
+         */
+        void Record(SpellProfileStage stage, uint64 micros) { m_stages[stage].Record(micros); }
+
+        /**
+         * @brief Account a Spell object allocation
+         */
+        void OnSpellCreated();
+
+        /**
+         * @brief Account a Spell object deallocation
+         */
+        void OnSpellDeleted();
+
+        /**
+         * @brief Account a Spell allocation served from a thread's Spell pool
+         */
+        void OnSpellRecycled();
+
+        /**
+         * @brief Clear all collected data
+         */
+        void Reset();
+
+        /**
+         * @brief Get number of recorded calls
+         * @param stage Measured stage
+         * @return Call count since last reset
+         */
+        uint64 GetCount(SpellProfileStage stage) const { return m_stages[stage].GetCount(); }
+
+        /**
+         * @brief Get average duration
+         * @param stage Measured stage
+         * @return Average duration in microseconds
+         */
+        uint64 GetAverage(SpellProfileStage stage) const { return m_stages[stage].GetAverage(); }
+
+        /**
+         * @brief Get maximum duration
+         * @param stage Measured stage
+         * @return Maximum duration in microseconds
+         */
+        uint64 GetMax(SpellProfileStage stage) const { return m_stages[stage].GetMax(); }
+
+        /**
+         * @brief Get latency percentile
+         *
+         * Resolution is limited by the log2 buckets, the upper bound of the
+         * bucket holding the percentile is returned.
+         *
+         * @param stage Measured stage
+         * @param percentile Percentile in range 0..100
+         * @return Duration in microseconds
+         */
+        uint64 GetPercentile(SpellProfileStage stage, float percentile) const { return m_stages[stage].GetPercentile(percentile); }
+
+        /**
+         * @brief Get calls per second since last reset
+         * @param stage Measured stage
+         * @return Rate of calls
+         */
+        float GetRate(SpellProfileStage stage) const;
+
+        /**
+         * @brief Get Spell objects allocated since last reset
+         * @return Allocation count
+         */
+        uint64 GetAllocatedSpells() const { return m_allocated.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get Spell allocations served from the thread pools since last reset
+         * @return Recycled allocation count
+         */
+        uint64 GetRecycledSpells() const { return m_recycled.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get highest number of Spells alive at once
+         * @return Peak live Spell count
+         */
+        int64 GetPeakSpells() const { return m_peakLive.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get Spell objects currently alive
+         * @return Live Spell count
+         */
+        int64 GetLiveSpells() const { return m_live.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get name of a stage for reports
+         * @param stage Measured stage
+         * @return Stage name
+         */
+        static char const* GetStageName(SpellProfileStage stage);
+
+    private:
+        std::atomic<bool> m_enabled;
+        std::atomic<uint32> m_resetTime;                    ///< getMSTime() of last reset
+        std::atomic<uint64> m_allocated;
+        std::atomic<uint64> m_recycled;
+        std::atomic<int64> m_live;                          ///< tracked even while disabled
+        std::atomic<int64> m_peakLive;                      ///< tracked even while disabled
+        LatencyHistogram m_stages[MAX_SPELL_PROFILE_STAGES];
+};
+
+#define sSpellProfiler MaNGOS::Singleton<SpellProfiler>::Instance()
+
+/**
+ * @brief Measures the enclosing scope for the SpellProfiler
+ *
+ * Records self time: the time of scopes nested in this one on the same
+ * thread is subtracted, so Spell::cast of an instant cast is not counted
+ * again in its Spell::prepare and a proc triggered by a proc only once.
+ * Costs a single flag check while profiling is disabled.
+ */
+class SpellProfileScope
+{
+    public:
+        explicit SpellProfileScope(SpellProfileStage stage) : m_stage(stage), m_active(sSpellProfiler.IsEnabled())
+        {
+            if (m_active)
+            {
+                Start();
+            }
+        }
+
+        ~SpellProfileScope()
+        {
+            if (m_active)
+            {
+                Stop();
+            }
+        }
+
+    private:
+        SpellProfileScope(SpellProfileScope const&);
+        SpellProfileScope& operator=(SpellProfileScope const&);
+
+        void Start();
+        void Stop();
+
+        SpellProfileStage m_stage;
+        bool m_active;
+        SpellProfileScope* m_parent;                        ///< enclosing measured scope of this thread
+        std::chrono::steady_clock::duration m_nested;       ///< time spent in nested measured scopes
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
@@ -49,6 +49,7 @@
 #include "SystemConfig.h"
 #include "Log.h"
 #include "Opcodes.h"
+#include "OpcodeStats.h"
 #include "WorldSession.h"
 #include "WorldPacket.h"
 #include "Player.h"
@@ -66,6 +67,7 @@
 #include "LootMgr.h"
 #include "ItemEnchantmentMgr.h"
 #include "MapManager.h"
+#include "SessionUpdater.h"
 #include "ScriptMgr.h"
 #include "CreatureAIRegistry.h"
 #include "ProgressBar.h"
@@ -197,6 +199,7 @@ World::World()
     m_ShutdownTimer = 0;
     m_gameTime = time(NULL);
     m_startTime = m_gameTime;
+    m_sessionUpdater = NULL;
     m_maxActiveSessionCount = 0;
     m_maxQueuedSessionCount = 0;
     m_NextDailyQuestReset = 0;
@@ -239,6 +242,8 @@ World::~World()
     eluna = nullptr;
 #endif /* ENABLE_ELUNA */
 
+    delete m_sessionUpdater;
+
     ///- Empty the kicked session set
     while (!m_sessions.empty())
     {
@@ -268,6 +273,10 @@ void World::CleanupsBeforeStop()
 {
     KickAll();                                       // save and kick all players
     UpdateSessions(1);                               // real players unload required UpdateSessions call
+    if (m_sessionUpdater)
+    {
+        m_sessionUpdater->deactivate();              // later session updates are serial
+    }
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
 }
 
@@ -637,6 +646,7 @@ void World::LoadConfigSettings(bool reload)
 
 
     LoadScheduledExitConfig();
+    sOpcodeStats.Initialize();
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps", "");
     if (!forceLoadGridOnMaps.empty())
@@ -661,6 +671,8 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUMTHREADS, "MapUpdateThreads", 2);
+    setConfig(CONFIG_UINT32_SESSION_UPDATE_THREADS, "SessionUpdateThreads", 0);
+    setConfig(CONFIG_UINT32_GRID_PRELOAD_TIME, "GridPreloadTime", 10);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
@@ -768,6 +780,9 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_GM_MAX_SPEED_FACTOR, "GM.MaxSpeedFactor", 10);
 
     setConfig(CONFIG_UINT32_GROUP_VISIBILITY, "Visibility.GroupMode", 0);
+    setConfigPos(CONFIG_FLOAT_MOVEMENT_FAR_DISTANCE, "Visibility.Movement.FarDistance", 50.0f);
+    setConfig(CONFIG_UINT32_MOVEMENT_FAR_INTERVAL, "Visibility.Movement.FarInterval", 1000);
+    setConfig(CONFIG_UINT32_SEND_BUDGET, "Network.SendBudget", 131072);
 
     setConfig(CONFIG_UINT32_MAIL_DELIVERY_DELAY, "MailDeliveryDelay", HOUR);
 
@@ -1077,6 +1092,7 @@ void World::LoadConfigSettings(bool reload)
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds", "");
+    setConfig(CONFIG_BOOL_VMAP_HEIGHT_CACHE, "vmap.enableHeightCache", true);
 
     if (!enableHeight)
     {
@@ -1091,6 +1107,9 @@ void World::LoadConfigSettings(bool reload)
     sLog.outString("WORLD: VMap data directory is: %svmaps", m_dataPath.c_str());
 
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
+    setConfigMinMax(CONFIG_UINT32_MMAP_MAX_PATH_LENGTH, "mmap.maxPathLength", 256, 74, 4096);
+    setConfigMinMax(CONFIG_UINT32_MMAP_PATH_CACHE_TIME, "mmap.pathCacheTime", 1000, 0, 10000);
+    setConfig(CONFIG_UINT32_MMAP_MEMORY_BUDGET, "mmap.memoryBudget", 0);
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds", "");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
@@ -1613,6 +1632,30 @@ void World::SetInitialWorldSettings()
     sMapMgr.Initialize();
     sLog.outString();
 
+    ///- Start the threads handling session safe packets
+    if (uint32 sessionThreads = getConfig(CONFIG_UINT32_SESSION_UPDATE_THREADS))
+    {
+#ifdef ENABLE_ELUNA
+        if (sElunaConfig->IsElunaEnabled() && sElunaConfig->IsElunaCompatibilityMode())
+        {
+            // packet hooks of the single Eluna state must not run on several threads
+            sLog.outError("SessionUpdateThreads set to %u, when Eluna in compatibility mode does not allow it, changing to 0", sessionThreads);
+            sessionThreads = 0;
+        }
+#endif /* ENABLE_ELUNA */
+
+        if (sessionThreads)
+        {
+            m_sessionUpdater = new SessionUpdater;
+            if (m_sessionUpdater->activate(sessionThreads) == -1)
+            {
+                sLog.outError("Failed to start %u session update threads, session packets are handled serially", sessionThreads);
+                delete m_sessionUpdater;
+                m_sessionUpdater = NULL;
+            }
+        }
+    }
+
     ///- Initialize Battlegrounds
     sLog.outString("Starting BattleGround System");
     sBattleGroundMgr.CreateInitialBattleGrounds();
@@ -1905,6 +1948,7 @@ void World::Update(uint32 diff)
 
     /// <li> Handle session updates
     UpdateSessions(diff);
+    sOpcodeStats.Update(diff);
 
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
@@ -2629,6 +2673,22 @@ void World::UpdateSessions(uint32 /*diff*/)
         AddSession_(sess);
     }
 
+    ///- Handle the packets that only touch their own session on the session update threads
+    if (m_sessionUpdater && m_sessionUpdater->activated())
+    {
+        m_sessionUpdateList.clear();
+        for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+        {
+            // idle sessions would only cost a dispatch
+            if (itr->second->HasParallelWork())
+            {
+                m_sessionUpdateList.push_back(itr->second);
+            }
+        }
+
+        m_sessionUpdater->Update(m_sessionUpdateList);
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(), next; itr != m_sessions.end(); itr = next)
     {
@@ -51,6 +51,7 @@ class Player;
 class SqlResultQueue;
 class QueryResult;
 class WorldSocket;
+class SessionUpdater;
 
 // ServerMessages.dbc
 enum ServerMessageType
@@ -192,6 +193,13 @@ enum eConfigUInt32Values
     CONFIG_UINT32_CHARDELETE_METHOD,
     CONFIG_UINT32_CHARDELETE_MIN_LEVEL,
     CONFIG_UINT32_NUMTHREADS,
+    CONFIG_UINT32_SESSION_UPDATE_THREADS,
+    CONFIG_UINT32_MOVEMENT_FAR_INTERVAL,
+    CONFIG_UINT32_SEND_BUDGET,
+    CONFIG_UINT32_GRID_PRELOAD_TIME,
+    CONFIG_UINT32_MMAP_MAX_PATH_LENGTH,
+    CONFIG_UINT32_MMAP_PATH_CACHE_TIME,
+    CONFIG_UINT32_MMAP_MEMORY_BUDGET,
     CONFIG_UINT32_GUID_RESERVE_SIZE_CREATURE,
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY,
@@ -292,6 +300,7 @@ enum eConfigFloatValues
     CONFIG_FLOAT_LISTEN_RANGE_SAY,
     CONFIG_FLOAT_LISTEN_RANGE_YELL,
     CONFIG_FLOAT_LISTEN_RANGE_TEXTEMOTE,
+    CONFIG_FLOAT_MOVEMENT_FAR_DISTANCE,
     CONFIG_FLOAT_CREATURE_FAMILY_FLEE_ASSISTANCE_RADIUS,
     CONFIG_FLOAT_CREATURE_FAMILY_ASSISTANCE_RADIUS,
     CONFIG_FLOAT_GROUP_XP_DISTANCE,
@@ -366,6 +375,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
+    CONFIG_BOOL_VMAP_HEIGHT_CACHE,
     CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,
     CONFIG_BOOL_MMAP_ENABLED,
     CONFIG_BOOL_PLAYER_COMMANDS,
@@ -766,6 +776,8 @@ class World
         uint32 mail_timer_expires;
 
         SessionMap m_sessions;
+        SessionUpdater* m_sessionUpdater;                   // handles session safe packets in parallel, NULL if off
+        std::vector<WorldSession*> m_sessionUpdateList;     // sessions handed to m_sessionUpdater, kept to reuse its memory
         uint32 m_maxActiveSessionCount;
         uint32 m_maxQueuedSessionCount;
 
@@ -129,7 +129,36 @@ namespace Movement
         unit.m_movementInfo.SetMovementFlags((MovementFlags)moveFlags);
         move_spline.Initialize(args);
 
-        WorldPacket data(SMSG_MONSTER_MOVE, 64);
+        // while the map updates, only the last spline launched in the update is sent
+        if (!unit.IsInWorld() || !unit.GetMap()->DeferSplineLaunch(&unit))
+        {
+            SendLaunched(unit);
+        }
+
+        return move_spline.Duration();
+    }
+
+    /**
+     * @brief Sends the current spline of a unit to the players around it.
+     * @param unit The moving unit.
+     */
+    void MoveSplineInit::SendLaunched(Unit& unit)
+    {
+        WorldPacket data;
+        BuildLaunched(unit, data);
+        unit.SendMessageToSet(&data, true);
+    }
+
+    /**
+     * @brief Builds the monster move packet of the current spline of a unit.
+     * @param unit The moving unit.
+     * @param data Receives the monster move packet.
+     */
+    void MoveSplineInit::BuildLaunched(Unit& unit, WorldPacket& data)
+    {
+        TransportInfo* transportInfo = unit.GetTransportInfo();
+
+        data.Initialize(SMSG_MONSTER_MOVE, 64);
         data << unit.GetPackGUID();
 
         if (transportInfo)
@@ -138,10 +167,7 @@ namespace Movement
             data << transportInfo->GetTransportGuid().WriteAsPacked();
         }
 
-        PacketBuilder::WriteMonsterMove(move_spline, data);
-        unit.SendMessageToSet(&data, true);
-
-        return move_spline.Duration();
+        PacketBuilder::WriteMonsterMove(*unit.movespline, data);
     }
 
     /**
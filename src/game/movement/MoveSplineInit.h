@@ -57,6 +57,19 @@ namespace Movement
              */
             void Stop();
 
+            /**
+             * @brief Sends the current spline of a unit to the players around it.
+             * @param unit The moving unit.
+             */
+            static void SendLaunched(Unit& unit);
+
+            /**
+             * @brief Builds the packet SendLaunched() sends.
+             * @param unit The moving unit.
+             * @param data Receives the monster move packet.
+             */
+            static void BuildLaunched(Unit& unit, WorldPacket& data);
+
             /**
              * @brief Adds final facing animation.
              * Sets unit's facing to specified point/angle after all path done.
@@ -88,8 +88,16 @@ namespace Movement
     void PacketBuilder::WriteCommonMonsterMovePart(const MoveSpline& move_spline, WorldPacket& data)
     {
         MoveSplineFlag splineflags = move_spline.splineflags;
+        bool resumed = IsResumed(move_spline);
 
-        data << move_spline.spline.getPoint(move_spline.spline.first());
+        if (resumed)
+        {
+            data << Vector3(move_spline.ComputePosition());
+        }
+        else
+        {
+            data << move_spline.spline.getPoint(move_spline.spline.first());
+        }
         data << move_spline.GetId();
 
         switch (splineflags & MoveSplineFlag::Mask_Final_Facing)
@@ -115,7 +123,54 @@ namespace Movement
         splineflags.enter_cycle = move_spline.isCyclic();
         // add fake Runmode flag - client has strange issues without that flag
         data << uint32((splineflags & ~MoveSplineFlag::Mask_No_Monster_Move) | MoveSplineFlag::Runmode);
-        data << move_spline.Duration();
+        data << (resumed ? move_spline.timeElapsed() : move_spline.Duration());
+    }
+
+    /**
+     * @brief Checks whether a monster move is written from the current position on.
+     *
+     * A launch sent later than it was made, e.g. deferred to the end of the map
+     * update, would make the client replay the part of the path the mover already
+     * walked. Linear paths are then written from the current position with the
+     * remaining duration. Smooth, cyclic and falling paths are always written whole.
+     *
+     * @param move_spline The MoveSpline object containing movement data.
+     * @return bool True if the spline is written from the current position on.
+     */
+    bool PacketBuilder::IsResumed(const MoveSpline& move_spline)
+    {
+        MoveSplineFlag splineflags = move_spline.splineflags;
+        return move_spline.time_passed > 0 && !splineflags.done && !splineflags.isSmooth() && !splineflags.cyclic && !splineflags.falling;
+    }
+
+    /**
+     * @brief Writes the part of a linear path that is still ahead of the mover.
+     *
+     * Same layout as WriteLinearPath(), starting at the current position written
+     * by WriteCommonMonsterMovePart().
+     *
+     * @param move_spline The MoveSpline object containing movement data.
+     * @param data The WorldPacket to write the data to.
+     */
+    void PacketBuilder::WriteRemainingLinearPath(const MoveSpline& move_spline, WorldPacket& data)
+    {
+        const MoveSpline::MySpline& spline = move_spline.spline;
+        uint32 last_idx = spline.last() - move_spline.point_Idx;
+        const Vector3* ahead = &spline.getPoint(move_spline.point_Idx + 1);
+
+        data << last_idx;
+        data << ahead[last_idx - 1];
+        if (last_idx > 1)
+        {
+            Vector3 destination = (Vector3(move_spline.ComputePosition()) + ahead[last_idx - 1]) / 2.f;
+            Vector3 offset;
+            // current position and last point already appended
+            for (uint32 i = 0; i < last_idx - 1; ++i)
+            {
+                offset = destination - ahead[i];
+                data.appendPackXYZ(offset.x, offset.y, offset.z);
+            }
+        }
     }
 
     /**
@@ -190,6 +245,10 @@ namespace Movement
                 WriteCatmullRomPath(spline, data);
             }
         }
+        else if (IsResumed(move_spline))
+        {
+            WriteRemainingLinearPath(move_spline, data);
+        }
         else
         {
             WriteLinearPath(spline, data);
@@ -43,6 +43,20 @@ namespace Movement
              * @param data The WorldPacket to write the data to.
              */
             static void WriteCommonMonsterMovePart(const MoveSpline& mov, WorldPacket& data);
+
+            /**
+             * @brief Checks whether a monster move is written from the current position on.
+             * @param mov The MoveSpline object containing movement data.
+             * @return bool True if a linear spline already advanced and is written from the current position.
+             */
+            static bool IsResumed(const MoveSpline& mov);
+
+            /**
+             * @brief Writes the part of a linear path that is still ahead of the mover.
+             * @param mov The MoveSpline object containing movement data.
+             * @param data The WorldPacket to write the data to.
+             */
+            static void WriteRemainingLinearPath(const MoveSpline& mov, WorldPacket& data);
         public:
 
             /**
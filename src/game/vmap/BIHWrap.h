@@ -149,6 +149,13 @@ class BIHWrap
             }
         }
 
+        /**
+         * @brief Tells whether objects were inserted or removed since the last build.
+         *
+         * @return bool
+         */
+        bool needsBalance() const { return unbalanced_times != 0; }
+
         /**
          * @brief
          *
@@ -0,0 +1,286 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file CollisionProfiler.cpp
+ * @brief Runtime statistics, capture and replay of collision queries
+ *
+ * Collects per query type counts, total/max durations and a log2 latency
+ * histogram for line of sight, height, area info and path queries. Static
+ * queries can be written to a capture file and replayed later against the
+ * extracted vmaps and maps to compare throughput and answers. Driven by the
+ * `.debug collisionprofile` command.
+ */
+
+#include "CollisionProfiler.h"
+#include "GridMap.h"
+#include "VMapFactory.h"
+#include "Log.h"
+#include "Timer.h"
+#include "Policies/Singleton.h"
+
+#include <map>
+
+INSTANTIATE_SINGLETON_1(CollisionProfiler);
+
+/**
+ * @brief Construct the profiler in disabled state
+ */
+CollisionProfiler::CollisionProfiler() : m_enabled(false), m_resetTime(0), m_capturing(false), m_captureFile(NULL), m_captured(0)
+{
+    Reset();
+}
+
+CollisionProfiler::~CollisionProfiler()
+{
+    StopCapture();
+}
+
+/**
+ * @brief Append a query and its answer to the capture file
+ *
+ * Called from map threads, writes are serialized by the capture lock and
+ * buffered by stdio.
+ *
+ * @param record Captured query
+ */
+void CollisionProfiler::Capture(CollisionQueryRecord const& record)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_captureLock);
+
+    if (!m_captureFile)
+    {
+        return;
+    }
+
+    if (fwrite(&record, sizeof(record), 1, m_captureFile) != 1 || ++m_captured >= COLLISION_CAPTURE_LIMIT)
+    {
+        sLog.outString("CollisionProfiler: capture stopped after %u queries", m_captured);
+        fclose(m_captureFile);
+        m_captureFile = NULL;
+        m_capturing.store(false, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Start capturing queries
+ * @param fileName File to write, truncated if it exists
+ * @return True if the file could be opened
+ */
+bool CollisionProfiler::StartCapture(std::string const& fileName)
+{
+    StopCapture();
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_captureLock, false);
+
+    m_captureFile = fopen(fileName.c_str(), "wb");
+    if (!m_captureFile)
+    {
+        return false;
+    }
+
+    uint32 header[2] = { COLLISION_CAPTURE_MAGIC, COLLISION_CAPTURE_VERSION };
+    fwrite(header, sizeof(header), 1, m_captureFile);
+
+    m_captured = 0;
+    m_capturing.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Stop capturing queries and close the file
+ * @return Number of captured queries
+ */
+uint32 CollisionProfiler::StopCapture()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_captureLock, 0);
+
+    m_capturing.store(false, std::memory_order_relaxed);
+    if (m_captureFile)
+    {
+        fclose(m_captureFile);
+        m_captureFile = NULL;
+    }
+
+    return m_captured;
+}
+
+/**
+ * @brief Replay a capture file
+ *
+ * Grids of the queried positions are loaded before a query is timed, so the
+ * measurement covers the query only and not the file loading. Queries skip
+ * the height cache, so the answers are compared with
+ * what the vmaps and maps return.
+ *
+ * Loads grids and vmap tiles that the map threads read, so it must run on
+ * the world thread while the maps are not updated. Console commands do,
+ * World::ProcessCliCommands() runs after MapManager::Update() waited for
+ * the map threads.
+ *
+ * @param fileName Capture file to read
+ * @param maxQueries Stop after this many queries, 0 for all
+ * @param result Receives query and mismatch counts
+ * @return False if the file could not be read
+ */
+bool CollisionProfiler::Replay(std::string const& fileName, uint32 maxQueries, CollisionReplayResult& result)
+{
+    memset(&result, 0, sizeof(result));
+
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    uint32 header[2];
+    if (fread(header, sizeof(header), 1, file) != 1 || header[0] != COLLISION_CAPTURE_MAGIC || header[1] != COLLISION_CAPTURE_VERSION)
+    {
+        fclose(file);
+        return false;
+    }
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+
+    // keep the terrain of every replayed map referenced until the end
+    typedef std::map<uint32, TerrainInfo*> TerrainMap;
+    TerrainMap terrains;
+
+    uint32 startTime = getMSTime();
+    uint32 replayed = 0;
+    CollisionQueryRecord rec;
+    while ((!maxQueries || replayed < maxQueries) && fread(&rec, sizeof(rec), 1, file) == 1)
+    {
+        if (rec.type >= MAX_COLLISION_QUERY_TYPES)
+        {
+            continue;
+        }
+
+        TerrainInfo*& terrain = terrains[rec.mapId];
+        if (!terrain)
+        {
+            terrain = sTerrainMgr.LoadTerrain(rec.mapId);
+            terrain->AddRef();
+        }
+
+        CollisionQueryType type = CollisionQueryType(rec.type);
+        terrain->GetTerrainType(rec.x, rec.y);              // loads grid and vmap tile
+        if (type == COLLISION_QUERY_LOS)
+        {
+            terrain->GetTerrainType(rec.x2, rec.y2);
+        }
+
+        bool match = true;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        switch (type)
+        {
+            case COLLISION_QUERY_LOS:
+            {
+                // static geometry only, as captured by Map::IsInLineOfSight
+                bool los = vmgr->isInLineOfSight(rec.mapId, rec.x, rec.y, rec.z, rec.x2, rec.y2, rec.z2);
+                match = los == (rec.flags != 0);
+                break;
+            }
+            case COLLISION_QUERY_HEIGHT:
+            {
+                float height = terrain->CalculateHeightStatic(rec.x, rec.y, rec.z, rec.flags != 0, rec.searchDist, false);
+                match = fabs(height - rec.height) < 0.05f;
+                break;
+            }
+            case COLLISION_QUERY_AREA_INFO:
+            {
+                uint32 mogpFlags = 0;
+                int32 adtId = 0, rootId = 0, groupId = 0;
+                bool found = terrain->GetAreaInfo(rec.x, rec.y, rec.z, mogpFlags, adtId, rootId, groupId);
+                match = found == (rec.flags != 0) &&
+                        (!found || (mogpFlags == rec.mogpFlags && adtId == rec.adtId && rootId == rec.rootId && groupId == rec.groupId));
+                break;
+            }
+            default:
+                break;
+        }
+        Record(type, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+        ++result.queries[type];
+        if (!match)
+        {
+            ++result.mismatches[type];
+            DEBUG_LOG("CollisionProfiler: %s query on map %u at (%f, %f, %f) changed its answer", GetTypeName(type), rec.mapId, rec.x, rec.y, rec.z);
+        }
+        ++replayed;
+    }
+
+    result.elapsed = GetMSTimeDiffToNow(startTime);
+    fclose(file);
+
+    for (TerrainMap::const_iterator itr = terrains.begin(); itr != terrains.end(); ++itr)
+    {
+        if (itr->second->Release())
+        {
+            sTerrainMgr.UnloadTerrain(itr->first);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Clear all collected latency data
+ */
+void CollisionProfiler::Reset()
+{
+    for (uint32 i = 0; i < MAX_COLLISION_QUERY_TYPES; ++i)
+    {
+        m_types[i].Reset();
+    }
+
+    m_resetTime.store(getMSTime(), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get queries per second since last reset
+ * @param type Query type
+ * @return Rate of queries
+ */
+float CollisionProfiler::GetRate(CollisionQueryType type) const
+{
+    return m_types[type].GetRate(GetMSTimeDiffToNow(m_resetTime.load(std::memory_order_relaxed)));
+}
+
+/**
+ * @brief Get name of a query type for reports
+ * @param type Query type
+ * @return Query type name
+ */
+char const* CollisionProfiler::GetTypeName(CollisionQueryType type)
+{
+    switch (type)
+    {
+        case COLLISION_QUERY_LOS:       return "los";
+        case COLLISION_QUERY_HEIGHT:    return "height";
+        case COLLISION_QUERY_AREA_INFO: return "area info";
+        case COLLISION_QUERY_PATH:      return "path";
+        default:                        return "unknown";
+    }
+}
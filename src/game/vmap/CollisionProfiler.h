@@ -0,0 +1,256 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_COLLISIONPROFILER_H
+#define MANGOS_COLLISIONPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Utilities/LatencyHistogram.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <chrono>
+#include <string>
+
+/**
+ * @brief Query types measured by the CollisionProfiler
+ */
+enum CollisionQueryType
+{
+    COLLISION_QUERY_LOS         = 0,                        ///< Map::IsInLineOfSight
+    COLLISION_QUERY_HEIGHT      = 1,                        ///< TerrainInfo::GetHeightStatic
+    COLLISION_QUERY_AREA_INFO   = 2,                        ///< TerrainInfo::GetAreaInfo
+    COLLISION_QUERY_PATH        = 3,                        ///< PathFinder::calculate
+    MAX_COLLISION_QUERY_TYPES
+};
+
+#define COLLISION_CAPTURE_MAGIC     0x5952514D              // 'MQRY'
+#define COLLISION_CAPTURE_VERSION   2                       // 2: answers recorded past the caches
+#define COLLISION_CAPTURE_LIMIT     2000000                 // records, capture stops when reached
+
+/**
+ * @brief One captured static collision query and its answer
+ *
+ * Only queries answered by static data (vmaps and .map files) are captured,
+ * so they can be replayed and compared later. All fields are 4 bytes wide,
+ * the record is written as is.
+ */
+struct CollisionQueryRecord
+{
+    uint32 type;                                            ///< CollisionQueryType
+    uint32 mapId;
+    float x, y, z;                                          ///< query position, LOS source
+    float x2, y2, z2;                                       ///< LOS destination
+    float searchDist;                                       ///< height search distance
+    uint32 flags;                                           ///< LOS result, height useVmaps, area info found
+    float height;                                           ///< height result
+    uint32 mogpFlags;                                       ///< area info results
+    int32 adtId;
+    int32 rootId;
+    int32 groupId;
+};
+
+/**
+ * @brief Summary of a replayed capture file
+ */
+struct CollisionReplayResult
+{
+    uint32 queries[MAX_COLLISION_QUERY_TYPES];
+    uint32 mismatches[MAX_COLLISION_QUERY_TYPES];
+    uint32 elapsed;                                         ///< wall time of the replay in ms
+};
+
+/**
+ * @brief Measures throughput and latency of collision and pathfinding queries
+ *
+ * Keeps a log2 latency histogram per query type while enabled. Static
+ * queries can additionally be captured into a file together with their
+ * answers; Replay() runs such a workload again against the loaded vmaps and
+ * maps, measures it and reports every answer that changed. Comparing a
+ * capture made before a change to BIH, MapTree, WorldModel or the terrain
+ * caches with a replay after it shows both the speedup and any regression.
+ */
+class CollisionProfiler
+{
+    public:
+        CollisionProfiler();
+        ~CollisionProfiler();
+
+        /**
+         * @brief Enable or disable latency recording
+         * @param enabled New state
+         */
+        void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+        /**
+         * @brief Check if latency recording is enabled
+         * @return True if enabled
+         */
+        bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Check if queries are captured
+         * @return True if a capture file is open
+         */
+        bool IsCapturing() const { return m_capturing.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Record one measured query
+         * @param type Query type
+         * @param micros Duration in microseconds
+         */
+        void Record(CollisionQueryType type, uint64 micros) { m_types[type].Record(micros); }
+
+        /**
+         * @brief Append a query and its answer to the capture file
+         * @param record Captured query
+         */
+        void Capture(CollisionQueryRecord const& record);
+
+        /**
+         * @brief Start capturing queries
+         * @param fileName File to write, truncated if it exists
+         * @return True if the file could be opened
+         */
+        bool StartCapture(std::string const& fileName);
+
+        /**
+         * @brief Stop capturing queries and close the file
+         * @return Number of captured queries
+         */
+        uint32 StopCapture();
+
+        /**
+         * @brief Replay a capture file
+         *
+         * Runs on the calling thread and blocks it until done, which must be
+         * the world thread outside the map update. Durations are recorded into
+         * this profiler, which should not be the global one.
+         *
+         * @param fileName Capture file to read
+         * @param maxQueries Stop after this many queries, 0 for all
+         * @param result Receives query and mismatch counts
+         * @return False if the file could not be read
+         */
+        bool Replay(std::string const& fileName, uint32 maxQueries, CollisionReplayResult& result);
+
+        /**
+         * @brief Clear all collected latency data
+         */
+        void Reset();
+
+        /**
+         * @brief Get number of recorded queries
+         * @param type Query type
+         * @return Query count since last reset
+         */
+        uint64 GetCount(CollisionQueryType type) const { return m_types[type].GetCount(); }
+
+        /**
+         * @brief Get average duration
+         * @param type Query type
+         * @return Average duration in microseconds
+         */
+        uint64 GetAverage(CollisionQueryType type) const { return m_types[type].GetAverage(); }
+
+        /**
+         * @brief Get maximum duration
+         * @param type Query type
+         * @return Maximum duration in microseconds
+         */
+        uint64 GetMax(CollisionQueryType type) const { return m_types[type].GetMax(); }
+
+        /**
+         * @brief Get latency percentile
+         * @param type Query type
+         * @param percentile Percentile in range 0..100
+         * @return Upper bound of the matching log2 bucket in microseconds
+         */
+        uint64 GetPercentile(CollisionQueryType type, float percentile) const { return m_types[type].GetPercentile(percentile); }
+
+        /**
+         * @brief Get queries per second since last reset
+         * @param type Query type
+         * @return Rate of queries
+         */
+        float GetRate(CollisionQueryType type) const;
+
+        /**
+         * @brief Get name of a query type for reports
+         * @param type Query type
+         * @return Query type name
+         */
+        static char const* GetTypeName(CollisionQueryType type);
+
+    private:
+        CollisionProfiler(CollisionProfiler const&);
+        CollisionProfiler& operator=(CollisionProfiler const&);
+
+        std::atomic<bool> m_enabled;
+        std::atomic<uint32> m_resetTime;                    ///< getMSTime() of last reset
+        LatencyHistogram m_types[MAX_COLLISION_QUERY_TYPES];
+
+        std::atomic<bool> m_capturing;
+        ACE_Thread_Mutex m_captureLock;                     ///< guards the members below
+        FILE* m_captureFile;
+        uint32 m_captured;
+};
+
+#define sCollisionProfiler MaNGOS::Singleton<CollisionProfiler>::Instance()
+
+/**
+ * @brief Measures the enclosing scope for the CollisionProfiler
+ *
+ * Costs a single flag check while profiling is disabled.
+ */
+class CollisionProfileScope
+{
+    public:
+        explicit CollisionProfileScope(CollisionQueryType type) : m_type(type), m_active(sCollisionProfiler.IsEnabled())
+        {
+            if (m_active)
+            {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~CollisionProfileScope()
+        {
+            if (m_active)
+            {
+                sCollisionProfiler.Record(m_type, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+            }
+        }
+
+    private:
+        CollisionProfileScope(CollisionProfileScope const&);
+        CollisionProfileScope& operator=(CollisionProfileScope const&);
+
+        CollisionQueryType m_type;
+        bool m_active;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
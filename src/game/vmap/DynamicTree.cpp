@@ -33,7 +33,8 @@
  *
  * Key features:
  * - Insert/remove dynamic objects
- * - Automatic rebalancing when tree becomes unbalanced
+ * - Amortized rebalancing of only the grid cells that changed
+ * - Queries outside the bounds of all objects skip the tree
  * - Ray intersection queries
  * - Area information queries
  *
@@ -67,6 +68,8 @@ template<> struct BoundsTrait< GameObjectModel>
 
 //int UNBALANCED_TIMES_LIMIT = 5;
 int CHECK_TREE_PERIOD = 200;
+// changed grid cells rebuilt per update, the rest wait for the next update or the first query reaching them
+int BALANCE_NODES_PER_UPDATE = 8;
 
 typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
 
@@ -77,7 +80,8 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 
     DynTreeImpl() :
         rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
+        unbalanced_times(0),
+        bounds_shrunk(false)
     {
     }
 
@@ -85,40 +89,105 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
     {
         base::insert(mdl);
         ++unbalanced_times;
+
+        const G3D::AABox& box = mdl.GetBounds();
+        if (size() == 1)
+        {
+            bounds_low = box.low();
+            bounds_high = box.high();
+        }
+        else
+        {
+            bounds_low = bounds_low.min(box.low());
+            bounds_high = bounds_high.max(box.high());
+        }
     }
 
     void remove(const Model& mdl)
     {
         base::remove(mdl);
         ++unbalanced_times;
+        bounds_shrunk = true;
     }
 
     void balance()
     {
         base::balance();
         unbalanced_times = 0;
+        updateBounds();
     }
 
     void update(uint32 difftime)
     {
-        if (!size())
+        if (!unbalanced_times)
         {
             return;
         }
 
+        // let changes pile up for a while, then spread the rebuilds over several updates
         rebalance_timer.Update(difftime);
         if (rebalance_timer.Passed())
         {
-            rebalance_timer.Reset(CHECK_TREE_PERIOD);
-            if (unbalanced_times > 0)
+            base::balance(BALANCE_NODES_PER_UPDATE);
+            if (!base::needsBalance())
             {
-                balance();
+                rebalance_timer.Reset(CHECK_TREE_PERIOD);
+                unbalanced_times = 0;
+                updateBounds();
             }
         }
     }
 
+    /**
+     * @brief Recalculates the bounds of all models after some were removed.
+     */
+    void updateBounds()
+    {
+        if (!bounds_shrunk)
+        {
+            return;
+        }
+
+        bounds_shrunk = false;
+        G3D::Array<const Model*> models;
+        memberTable.getKeys(models);
+        for (int i = 0; i < models.size(); ++i)
+        {
+            const G3D::AABox& box = models[i]->GetBounds();
+            bounds_low = i ? bounds_low.min(box.low()) : box.low();
+            bounds_high = i ? bounds_high.max(box.high()) : box.high();
+        }
+    }
+
+    /**
+     * @brief Tells whether a segment can touch any model.
+     *
+     * Most queries of a map happen far away from its doors and other
+     * dynamic objects, those skip the tree entirely.
+     *
+     * @param start The start of the segment.
+     * @param end The end of the segment.
+     * @return false if the segment lies outside the bounds of all models.
+     */
+    bool mayIntersect(const Vector3& start, const Vector3& end) const
+    {
+        if (!size())
+        {
+            return false;
+        }
+
+        Vector3 low = start.min(end);
+        Vector3 high = start.max(end);
+        return low.x <= bounds_high.x && high.x >= bounds_low.x &&
+               low.y <= bounds_high.y && high.y >= bounds_low.y &&
+               low.z <= bounds_high.z && high.z >= bounds_low.z;
+    }
+
     TimeTracker rebalance_timer;
     int unbalanced_times;
+    Vector3 bounds_low;                                     // bounds of all models, may be larger than needed
+    Vector3 bounds_high;                                    // until recalculated after removals
+    bool bounds_shrunk;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(*new DynTreeImpl())
@@ -230,6 +299,11 @@ Else, pMaxDist is not modified and returns false;
 
 bool DynamicMapTree::getIntersectionTime(const G3D::Ray& ray, const Vector3& endPos, float& pMaxDist) const
 {
+    if (!impl.mayIntersect(ray.origin(), endPos))
+    {
+        return false;
+    }
+
     float distance = pMaxDist;
     DynamicTreeIntersectionCallback callback;
     impl.intersectRay(ray, callback, distance, endPos);
@@ -318,7 +392,7 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
 
     float maxDist = (v2 - v1).magnitude();
 
-    if (!G3D::fuzzyGt(maxDist, 0))
+    if (!G3D::fuzzyGt(maxDist, 0) || !impl.mayIntersect(v1, v2))
     {
         return true;
     }
@@ -342,6 +416,11 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
 float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist) const
 {
     Vector3 v(x, y, z);
+    if (!impl.mayIntersect(v, Vector3(x, y, z - maxSearchDist)))
+    {
+        return -G3D::inf();
+    }
+
     G3D::Ray r(v, Vector3(0, 0, -1));
     DynamicTreeIntersectionCallback callback;
     impl.intersectZAllignedRay(r, callback, maxSearchDist);
@@ -0,0 +1,108 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "HeightCache.h"
+
+#include <cmath>
+#include <cstring>
+
+/// Map id of an unused entry
+#define HEIGHT_CACHE_EMPTY      uint32(-1)
+
+HeightCache::HeightCache() : m_hits(0), m_misses(0)
+{
+}
+
+HeightCache& HeightCache::ForThisThread()
+{
+    static thread_local HeightCache cache;
+    return cache;
+}
+
+/**
+ * @brief Hashes a map id and the exact bits of a position to a slot.
+ *
+ * @param mapId The map id.
+ * @param x The X coordinate.
+ * @param y The Y coordinate.
+ * @return The slot of the position.
+ */
+uint32 HeightCache::GetSlot(uint32 mapId, float x, float y)
+{
+    uint32 bx, by;
+    memcpy(&bx, &x, sizeof(bx));
+    memcpy(&by, &y, sizeof(by));
+
+    uint64 key = (uint64(bx) << 32 | by) ^ (uint64(mapId) * 0xC2B2AE3D27D4EB4FULL);
+    return uint32((key * 0x9E3779B97F4A7C15ULL) >> 51) & (HEIGHT_CACHE_SIZE - 1);
+}
+
+bool HeightCache::Lookup(uint32 mapId, uint32 generation, float x, float y, float z, float maxSearchDist, float& height)
+{
+    if (m_entries.empty())
+    {
+        ++m_misses;
+        return false;
+    }
+
+    Entry const& entry = m_entries[GetSlot(mapId, x, y)];
+    if (entry.mapId != mapId || entry.generation != generation || entry.x != x || entry.y != y ||
+        z < entry.floor || z > entry.top || z - entry.floor > maxSearchDist)
+    {
+        ++m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    height = entry.floor;
+    return true;
+}
+
+void HeightCache::Store(uint32 mapId, uint32 generation, float x, float y, float z, float height)
+{
+    if (m_entries.empty())
+    {
+        Entry empty = { HEIGHT_CACHE_EMPTY, 0, 0.0f, 0.0f, 0.0f, 0.0f };
+        m_entries.assign(HEIGHT_CACHE_SIZE, empty);
+    }
+
+    Entry& entry = m_entries[GetSlot(mapId, x, y)];
+
+    // same floor found from higher up, widen the band
+    if (entry.mapId == mapId && entry.generation == generation && entry.x == x && entry.y == y && entry.floor == height)
+    {
+        if (z > entry.top)
+        {
+            entry.top = z;
+        }
+        return;
+    }
+
+    entry.mapId = mapId;
+    entry.generation = generation;
+    entry.x = x;
+    entry.y = y;
+    entry.floor = height;
+    entry.top = z;
+}
@@ -0,0 +1,112 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_HEIGHTCACHE_H
+#define MANGOS_HEIGHTCACHE_H
+
+#include "Platform/Define.h"
+
+#include <vector>
+
+/// Number of entries of a cache, must be a power of two
+#define HEIGHT_CACHE_SIZE       8192
+
+/**
+ * @brief Caches results of vmap floor height queries.
+ *
+ * A vmap height query casts a ray down from z and returns the first floor
+ * hit. When the floor at height h was found from z, nothing lies between h
+ * and z, so every query starting anywhere in [h, z] finds the same floor.
+ * Each entry remembers such a band for one exact x, y position and answers
+ * queries falling inside it without a ray cast.
+ *
+ * Entries are tagged with the vmap generation of the terrain, which changes
+ * whenever a vmap tile of the map is loaded or unloaded, see
+ * TerrainInfo::GetVMapGeneration(). Terrain is shared by all instances of a
+ * map and queried from every map thread, so each thread keeps its own cache,
+ * see ForThisThread().
+ */
+class HeightCache
+{
+    public:
+        /**
+         * @brief Constructor for HeightCache.
+         */
+        HeightCache();
+
+        /**
+         * @brief Returns the cache of the calling thread.
+         *
+         * @return The cache of the calling thread.
+         */
+        static HeightCache& ForThisThread();
+
+        /**
+         * @brief Looks up the floor under a position.
+         *
+         * @param mapId The map id.
+         * @param generation The vmap generation of the terrain.
+         * @param x The X coordinate.
+         * @param y The Y coordinate.
+         * @param z The height the ray starts at.
+         * @param maxSearchDist The maximum length of the ray.
+         * @param height Receives the cached floor height.
+         * @return true if the floor was cached; otherwise false.
+         */
+        bool Lookup(uint32 mapId, uint32 generation, float x, float y, float z, float maxSearchDist, float& height);
+
+        /**
+         * @brief Stores the floor found under a position.
+         *
+         * @param mapId The map id.
+         * @param generation The vmap generation of the terrain, read before the ray was cast.
+         * @param x The X coordinate.
+         * @param y The Y coordinate.
+         * @param z The height the ray started at.
+         * @param height The floor height found.
+         */
+        void Store(uint32 mapId, uint32 generation, float x, float y, float z, float height);
+
+        uint64 GetHits() const { return m_hits; }
+        uint64 GetMisses() const { return m_misses; }
+
+    private:
+        struct Entry
+        {
+            uint32 mapId;
+            uint32 generation;                              // vmap generation the floor was found in
+            float x;
+            float y;
+            float floor;                                    // height of the floor
+            float top;                                      // highest ray start known to reach the floor
+        };
+
+        static uint32 GetSlot(uint32 mapId, float x, float y);
+
+        std::vector<Entry> m_entries;                       // allocated at the first Store
+        uint64 m_hits;
+        uint64 m_misses;
+};
+
+#endif
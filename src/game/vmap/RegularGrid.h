@@ -29,9 +29,12 @@
 #include <G3D/AABox.h>
 #include <G3D/Table.h>
 #include <G3D/PositionTrait.h>
+#include <G3D/Array.h>
 
 #include "Errors.h"
 
+#include <algorithm>
+
 using G3D::Vector2;
 using G3D::Vector3;
 using G3D::AABox;
@@ -88,6 +91,7 @@ class RegularGrid2D
 
         MemberTable memberTable; /**< TODO */
         Node* nodes[CELL_NUMBER][CELL_NUMBER]; /**< TODO */
+        G3D::Array<Node*> dirtyNodes; /**< nodes changed since their last build, may hold duplicates */
 
         /**
          * @brief
@@ -123,6 +127,10 @@ class RegularGrid2D
             Vector3 pos;
             PositionFunc::getPosition(value, pos);
             Node& node = getGridFor(pos.x, pos.y);
+            if (!node.needsBalance())
+            {
+                dirtyNodes.append(&node);
+            }
             node.insert(value);
             memberTable.set(&value, &node);
         }
@@ -134,7 +142,12 @@ class RegularGrid2D
          */
         void remove(const T& value)
         {
-            memberTable[&value]->remove(value);
+            Node* node = memberTable[&value];
+            if (!node->needsBalance())
+            {
+                dirtyNodes.append(node);
+            }
+            node->remove(value);
             // Remove the member
             memberTable.remove(&value);
         }
@@ -145,18 +158,35 @@ class RegularGrid2D
          */
         void balance()
         {
-            for (int x = 0; x < CELL_NUMBER; ++x)
+            balance(dirtyNodes.size());
+        }
+
+        /**
+         * @brief Rebuilds at most maxNodes of the changed nodes.
+         *
+         * Only nodes touched by insert() or remove() are rebuilt, the rest of
+         * the grid is left alone. Nodes left over are built by a later call,
+         * or when a query reaches them first.
+         *
+         * @param maxNodes The maximum number of nodes to rebuild.
+         */
+        void balance(int maxNodes)
+        {
+            int count = std::min(maxNodes, dirtyNodes.size());
+            for (int i = 0; i < count; ++i)
             {
-                for (int y = 0; y < CELL_NUMBER; ++y)
-                {
-                    if (Node* n = nodes[x][y])
-                    {
-                        n->balance();
-                    }
-                }
+                dirtyNodes[i]->balance();
             }
+            dirtyNodes.remove(0, count);
         }
 
+        /**
+         * @brief Tells whether changed nodes are waiting for a rebuild.
+         *
+         * @return bool
+         */
+        bool needsBalance() const { return dirtyNodes.size() != 0; }
+
         /**
          * @brief
          *
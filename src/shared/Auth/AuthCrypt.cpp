@@ -35,6 +35,8 @@ const static size_t CRYPTED_RECV_LEN = 6;
  */
 AuthCrypt::AuthCrypt()
 {
+    memset(_key, 0, sizeof(_key));
+    _send_i = _send_j = _recv_i = _recv_j = 0;
     _initialized = false;
 }
 
@@ -52,14 +54,22 @@ void AuthCrypt::DecryptRecv(uint8* data, size_t len)
         return;
     }
 
+    uint8 i = _recv_i;
+    uint8 j = _recv_j;
+
     for (size_t t = 0; t < CRYPTED_RECV_LEN; t++)
     {
-        _recv_i %= _key.size();
-        uint8 x = (data[t] - _recv_j) ^ _key[_recv_i];
-        ++_recv_i;
-        _recv_j = data[t];
+        if (i == KEY_SIZE)
+        {
+            i = 0;
+        }
+        uint8 x = (data[t] - j) ^ _key[i++];
+        j = data[t];
         data[t] = x;
     }
+
+    _recv_i = i;
+    _recv_j = j;
 }
 
 /**
@@ -77,13 +87,39 @@ void AuthCrypt::EncryptSend(uint8* data, size_t len)
         return;
     }
 
-    for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+    size_t offset = 0;
+    EncryptSendHeaders(data, &offset, 1);
+}
+
+/**
+ * Encrypts the outgoing headers at the given offsets of one buffer, in order.
+ */
+void AuthCrypt::EncryptSendHeaders(uint8* buffer, size_t const* offsets, size_t count)
+{
+    if (!_initialized)
+    {
+        return;
+    }
+
+    uint8 i = _send_i;
+    uint8 j = _send_j;
+
+    for (size_t h = 0; h < count; ++h)
     {
-        _send_i %= _key.size();
-        uint8 x = (data[t] ^ _key[_send_i]) + _send_j;
-        ++_send_i;
-        data[t] = _send_j = x;
+        uint8* data = buffer + offsets[h];
+
+        for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+        {
+            if (i == KEY_SIZE)
+            {
+                i = 0;
+            }
+            data[t] = j = (data[t] ^ _key[i++]) + j;
+        }
     }
+
+    _send_i = i;
+    _send_j = j;
 }
 
 /**
@@ -91,15 +127,11 @@ void AuthCrypt::EncryptSend(uint8* data, size_t len)
  */
 void AuthCrypt::Init(BigNumber* K)
 {
-    uint8* key = new uint8[SHA_DIGEST_LENGTH];
     uint8 recvSeed[SEED_KEY_SIZE] = { 0x38, 0xA7, 0x83, 0x15, 0xF8, 0x92, 0x25, 0x30, 0x71, 0x98, 0x67, 0xB1, 0x8C, 0x4, 0xE2, 0xAA };
     HMACSHA1 recvHash(SEED_KEY_SIZE, (uint8*)recvSeed);
     recvHash.UpdateBigNumber(K);
     recvHash.Finalize();
-    memcpy(key, recvHash.GetDigest(), SHA_DIGEST_LENGTH);
-    _key.resize(SHA_DIGEST_LENGTH);
-    std::copy(key, key + SHA_DIGEST_LENGTH, _key.begin());
-    delete[] key;
+    memcpy(_key, recvHash.GetDigest(), KEY_SIZE);
 
     _send_i = _send_j = _recv_i = _recv_j = 0;
     _initialized = true;
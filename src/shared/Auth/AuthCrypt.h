@@ -26,7 +26,6 @@
 #define MANGOS_H_AUTHCRYPT
 
 #include "Common/Common.h"
-#include <vector>
 
 class BigNumber;
 
@@ -66,6 +65,16 @@ class AuthCrypt
          * @param len Length of data to encrypt
          */
         void EncryptSend(uint8*, size_t);
+        /**
+         * @brief Encrypt the headers of several outgoing packets in one pass
+         * @param buffer Buffer holding the packets, headers still in clear
+         * @param offsets Offset of every header in the buffer, in send order
+         * @param count Number of headers
+         *
+         * Same result as calling EncryptSend() for each header in turn, but
+         * the stream state stays in registers for the whole batch.
+         */
+        void EncryptSendHeaders(uint8* buffer, size_t const* offsets, size_t count);
 
         /**
          * @brief Check if the crypt object is initialized
@@ -74,7 +83,9 @@ class AuthCrypt
         bool IsInitialized() { return _initialized; }
 
     private:
-        std::vector<uint8> _key; /**< Session key for encryption */
+        static const size_t KEY_SIZE = 20; /**< Length of the HMAC-SHA1 session key */
+
+        uint8 _key[KEY_SIZE]; /**< Session key for encryption */
         uint8 _send_i, _send_j, _recv_i, _recv_j; /**< ARC4 state variables for send/recv */
         bool _initialized; /**< Initialization status */
 };
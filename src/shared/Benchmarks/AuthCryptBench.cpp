@@ -0,0 +1,279 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file AuthCryptBench.cpp
+ * @brief Microbenchmark of the world packet header crypt
+ *
+ * Times AuthCrypt from the shared library against the header crypt as it
+ * was before the batched header encryption: one call per packet, the key in
+ * a std::vector and the key index wrapped with a modulo per byte. Only that
+ * old path is kept here, as the reference.
+ *
+ * Before timing, the program checks that AuthCrypt and the reference give
+ * the same byte streams for random session keys and headers, and stops if
+ * they do not.
+ *
+ * Built with -DBUILD_BENCHMARKS=1, run from the build directory:
+ *     authcrypt_bench [packets per flush] [flushes]
+ *
+ * Defaults are 32 packets per flush and 200000 flushes. The output is the
+ * time per header of every variant and its ratio to the reference.
+ */
+
+#include "Auth/AuthCrypt.h"
+#include "Auth/BigNumber.h"
+#include "Auth/HMACSHA1.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const size_t CRYPTED_SEND_LEN = 4;
+static const size_t CRYPTED_RECV_LEN = 6;
+
+/**
+ * @brief The per packet header crypt before the batched header encryption
+ */
+class ReferenceCrypt
+{
+    public:
+        /**
+         * @brief Derive the stream key from the session key like AuthCrypt::Init()
+         * @param K Session key
+         */
+        explicit ReferenceCrypt(BigNumber* K) : _send_i(0), _send_j(0), _recv_i(0), _recv_j(0)
+        {
+            uint8 recvSeed[SEED_KEY_SIZE] = { 0x38, 0xA7, 0x83, 0x15, 0xF8, 0x92, 0x25, 0x30, 0x71, 0x98, 0x67, 0xB1, 0x8C, 0x4, 0xE2, 0xAA };
+            HMACSHA1 recvHash(SEED_KEY_SIZE, (uint8*)recvSeed);
+            recvHash.UpdateBigNumber(K);
+            recvHash.Finalize();
+            _key.assign(recvHash.GetDigest(), recvHash.GetDigest() + recvHash.GetLength());
+        }
+
+        void DecryptRecv(uint8* data)
+        {
+            for (size_t t = 0; t < CRYPTED_RECV_LEN; t++)
+            {
+                _recv_i %= _key.size();
+                uint8 x = (data[t] - _recv_j) ^ _key[_recv_i];
+                ++_recv_i;
+                _recv_j = data[t];
+                data[t] = x;
+            }
+        }
+
+        void EncryptSend(uint8* data)
+        {
+            for (size_t t = 0; t < CRYPTED_SEND_LEN; t++)
+            {
+                _send_i %= _key.size();
+                uint8 x = (data[t] ^ _key[_send_i]) + _send_j;
+                ++_send_i;
+                data[t] = _send_j = x;
+            }
+        }
+
+    private:
+        std::vector<uint8> _key;
+        uint8 _send_i, _send_j, _recv_i, _recv_j;
+};
+
+/**
+ * @brief One flush worth of packets in a send buffer
+ */
+struct Flush
+{
+    std::vector<uint8> buffer;
+    std::vector<size_t> offsets;                            // header offsets, in send order
+};
+
+/**
+ * @brief Build a flush of packets with random sizes and contents
+ * @param rng Random source
+ * @param packets Number of packets
+ * @return Flush with clear headers
+ */
+static Flush MakeFlush(std::mt19937& rng, size_t packets)
+{
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> body(0, 120);        // most server packets are small
+
+    Flush flush;
+    for (size_t p = 0; p < packets; ++p)
+    {
+        flush.offsets.push_back(flush.buffer.size());
+        size_t size = CRYPTED_SEND_LEN + body(rng);
+        for (size_t b = 0; b < size; ++b)
+        {
+            flush.buffer.push_back(uint8(byte(rng)));
+        }
+    }
+    return flush;
+}
+
+/**
+ * @brief Check that AuthCrypt and the reference produce the same byte streams
+ * @param rng Random source
+ * @return True if they do
+ */
+static bool Verify(std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    for (int round = 0; round < 100; ++round)
+    {
+        BigNumber K;
+        K.SetRand(40 * 8);
+
+        ReferenceCrypt reference(&K);
+        AuthCrypt batched, single;
+        batched.Init(&K);
+        single.Init(&K);
+
+        for (int f = 0; f < 50; ++f)
+        {
+            Flush a = MakeFlush(rng, 1 + f % 40);
+            Flush b = a;
+            Flush c = a;
+
+            for (size_t h = 0; h < a.offsets.size(); ++h)
+            {
+                reference.EncryptSend(&a.buffer[a.offsets[h]]);
+                single.EncryptSend(&c.buffer[c.offsets[h]], CRYPTED_SEND_LEN);
+            }
+            batched.EncryptSendHeaders(&b.buffer[0], &b.offsets[0], b.offsets.size());
+            if (a.buffer != b.buffer || a.buffer != c.buffer)
+            {
+                return false;
+            }
+
+            uint8 recvA[CRYPTED_RECV_LEN], recvB[CRYPTED_RECV_LEN];
+            for (size_t t = 0; t < CRYPTED_RECV_LEN; ++t)
+            {
+                recvA[t] = recvB[t] = uint8(byte(rng));
+            }
+            reference.DecryptRecv(recvA);
+            batched.DecryptRecv(recvB, CRYPTED_RECV_LEN);
+            if (memcmp(recvA, recvB, CRYPTED_RECV_LEN) != 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Nanoseconds between two time points
+ */
+static double Nanoseconds(Clock::time_point start, Clock::time_point end)
+{
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+int main(int argc, char** argv)
+{
+    size_t packets = argc > 1 ? size_t(strtoul(argv[1], NULL, 10)) : 32;
+    size_t flushes = argc > 2 ? size_t(strtoul(argv[2], NULL, 10)) : 200000;
+    if (!packets || !flushes)
+    {
+        printf("Usage: %s [packets per flush] [flushes]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937 rng(12345);
+    if (!Verify(rng))
+    {
+        printf("AuthCrypt and the reference crypt differ, results are meaningless\n");
+        return 1;
+    }
+
+    BigNumber K;
+    K.SetRand(40 * 8);
+
+    // the buffer is encrypted over and over, only the timing matters here
+    Flush flush = MakeFlush(rng, packets);
+    ReferenceCrypt reference(&K);
+    AuthCrypt crypt;
+    crypt.Init(&K);
+    uint8 recv[CRYPTED_RECV_LEN] = { 0 };
+    double headers = double(packets) * double(flushes);
+
+    Clock::time_point start = Clock::now();
+    for (size_t f = 0; f < flushes; ++f)
+    {
+        for (size_t h = 0; h < flush.offsets.size(); ++h)
+        {
+            reference.EncryptSend(&flush.buffer[flush.offsets[h]]);
+        }
+    }
+    double referenceSend = Nanoseconds(start, Clock::now()) / headers;
+
+    start = Clock::now();
+    for (size_t f = 0; f < flushes; ++f)
+    {
+        for (size_t h = 0; h < flush.offsets.size(); ++h)
+        {
+            crypt.EncryptSend(&flush.buffer[flush.offsets[h]], CRYPTED_SEND_LEN);
+        }
+    }
+    double singleSend = Nanoseconds(start, Clock::now()) / headers;
+
+    start = Clock::now();
+    for (size_t f = 0; f < flushes; ++f)
+    {
+        crypt.EncryptSendHeaders(&flush.buffer[0], &flush.offsets[0], flush.offsets.size());
+    }
+    double batchedSend = Nanoseconds(start, Clock::now()) / headers;
+
+    start = Clock::now();
+    for (size_t h = 0; h < size_t(headers); ++h)
+    {
+        reference.DecryptRecv(recv);
+    }
+    double referenceRecv = Nanoseconds(start, Clock::now()) / headers;
+
+    start = Clock::now();
+    for (size_t h = 0; h < size_t(headers); ++h)
+    {
+        crypt.DecryptRecv(recv, CRYPTED_RECV_LEN);
+    }
+    double authCryptRecv = Nanoseconds(start, Clock::now()) / headers;
+
+    // printed so the loops above can not be optimized away
+    printf("%u packets per flush, %u flushes (checksum %02X%02X)\n", unsigned(packets), unsigned(flushes), flush.buffer[0], recv[0]);
+    printf("send: reference %.2f ns/header\n", referenceSend);
+    printf("      EncryptSend %.2f ns/header, %.2fx\n", singleSend, referenceSend / singleSend);
+    printf("      EncryptSendHeaders %.2f ns/header, %.2fx\n", batchedSend, referenceSend / batchedSend);
+    printf("recv: reference %.2f ns/header\n", referenceRecv);
+    printf("      DecryptRecv %.2f ns/header, %.2fx\n", authCryptRecv, referenceRecv / authCryptRecv);
+    return 0;
+}
@@ -40,6 +40,7 @@
 
 #include "Common/Common.h"
 #include "Log.h"
+#include "LogWriter.h"
 #include "Policies/Singleton.h"
 #include "Config/Config.h"
 #include "Utilities/Util.h"
@@ -105,7 +106,7 @@ Log::Log()
 #endif /* ENABLE_ELUNA */
 
 eventAiErLogfile(NULL), scriptErrLogFile(NULL), worldLogfile(NULL), wardenLogfile(NULL), m_colored(false),
-    m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL)
+    m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL), m_writer(NULL), m_writerThread(NULL)
 {
     Initialize();
 }
@@ -358,6 +359,8 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    StartAsyncWriter();
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -441,6 +444,111 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
+/**
+ * @brief Write one line to a log file
+ *
+ * Queues the line to the writer thread when asynchronous logging is
+ * enabled, otherwise writes and flushes it on the calling thread.
+ *
+ * @param file Target file
+ * @param text Line text without line end
+ * @param length Text length
+ * @param timestamp True to prefix the line with the current time
+ * @param important True if the line must not be dropped on overflow
+ */
+void Log::WriteLine(FILE* file, char const* text, size_t length, bool timestamp, bool important)
+{
+    if (m_writer && m_writer->Write(file, text, length, timestamp, important))
+    {
+        return;
+    }
+
+    if (timestamp)
+    {
+        outTimestamp(file);
+    }
+
+    fwrite(text, 1, length, file);
+    fputc('\n', file);
+    fflush(file);
+}
+
+/**
+ * @brief Format and write one line to a log file
+ * @param file Target file
+ * @param prefix Text put before the message, may be NULL
+ * @param format printf style format of the message
+ * @param important True if the line must not be dropped on overflow
+ * @param ap Format arguments
+ */
+void Log::WriteFormatted(FILE* file, char const* prefix, char const* format, bool important, va_list ap)
+{
+    char buf[1024];
+
+    size_t prefixLen = 0;
+    if (prefix)
+    {
+        prefixLen = std::min(strlen(prefix), sizeof(buf) - 1);
+        memcpy(buf, prefix, prefixLen);
+    }
+
+    va_list apCopy;
+    va_copy(apCopy, ap);
+    int len = vsnprintf(buf + prefixLen, sizeof(buf) - prefixLen, format, ap);
+    if (len < 0)
+    {
+        len = 0;
+    }
+
+    if (prefixLen + len < sizeof(buf))
+    {
+        WriteLine(file, buf, prefixLen + len, true, important);
+    }
+    else
+    {
+        std::string text(prefixLen + len + 1, '\0');
+        memcpy(&text[0], buf, prefixLen);
+        vsnprintf(&text[prefixLen], len + 1, format, apCopy);
+        WriteLine(file, text.c_str(), prefixLen + len, true, important);
+    }
+
+    va_end(apCopy);
+}
+
+/**
+ * @brief Start the asynchronous writer if it is configured
+ */
+void Log::StartAsyncWriter()
+{
+    uint32 bufferSize = sConfig.GetIntDefault("LogAsyncBufferSize", 0);
+    if (!bufferSize || m_writer)
+    {
+        return;
+    }
+
+    m_writer = new LogWriter(bufferSize * 1024, sConfig.GetIntDefault("LogAsyncOverflow", 0) == 0, logfile);
+    m_writerThread = new ACE_Based::Thread(m_writer);     // owns m_writer
+}
+
+/**
+ * @brief Stop the asynchronous writer after writing all queued lines
+ */
+void Log::StopAsyncWriter()
+{
+    if (!m_writerThread)
+    {
+        return;
+    }
+
+    LogWriter* writer = m_writer;
+    m_writer = NULL;                                        // new lines are written directly
+
+    writer->Stop();
+    m_writerThread->wait();
+    delete m_writerThread;                                  // This also deletes the writer
+    m_writerThread = NULL;
+}
+
 void Log::outString()
 {
     if (m_includeTime)
@@ -450,9 +558,7 @@ void Log::outString()
     printf("\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        WriteLine(logfile, "", 0, true, false);
     }
 
     fflush(stdout);
@@ -490,14 +596,9 @@ void Log::outString(const char* str, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        WriteFormatted(logfile, NULL, str, false, ap);
         va_end(ap);
-
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -534,15 +635,9 @@ void Log::outError(const char* err, ...)
     fprintf(stderr, "\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteFormatted(logfile, "ERROR:", err, true, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stderr);
@@ -559,16 +654,12 @@ void Log::outErrorDb()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
+        WriteLine(logfile, "ERROR:", 6, true, true);
     }
 
     if (dberLogfile)
     {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        WriteLine(dberLogfile, "", 0, true, true);
     }
 
     fflush(stderr);
@@ -606,28 +697,17 @@ void Log::outErrorDb(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteFormatted(logfile, "ERROR:", err, true, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (dberLogfile)
     {
-        outTimestamp(dberLogfile);
-
         va_list ap;
         va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
+        WriteFormatted(dberLogfile, NULL, err, true, ap);
         va_end(ap);
-
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
     }
 
     fflush(stderr);
@@ -645,16 +725,12 @@ void Log::outErrorEluna()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna\n");
-        fflush(logfile);
+        WriteLine(logfile, "ERROR Eluna", 11, true, true);
     }
 
     if (elunaErrLogfile)
     {
-        outTimestamp(elunaErrLogfile);
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
+        WriteLine(elunaErrLogfile, "", 0, true, true);
     }
 
     fflush(stderr);
@@ -697,28 +773,17 @@ void Log::outErrorEluna(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteFormatted(logfile, "ERROR Eluna: ", err, true, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (elunaErrLogfile)
     {
-        outTimestamp(elunaErrLogfile);
-
         va_list ap;
         va_start(ap, err);
-        vfprintf(elunaErrLogfile, err, ap);
+        WriteFormatted(elunaErrLogfile, NULL, err, true, ap);
         va_end(ap);
-
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
     }
 
     fflush(stderr);
@@ -739,16 +804,12 @@ void Log::outErrorEventAI()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
+        WriteLine(logfile, "ERROR CreatureEventAI", 21, true, true);
     }
 
     if (eventAiErLogfile)
     {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
+        WriteLine(eventAiErLogfile, "", 0, true, true);
     }
 
     fflush(stderr);
@@ -786,28 +847,17 @@ void Log::outErrorEventAI(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteFormatted(logfile, "ERROR CreatureEventAI: ", err, true, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (eventAiErLogfile)
     {
-        outTimestamp(eventAiErLogfile);
-
         va_list ap;
         va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
+        WriteFormatted(eventAiErLogfile, NULL, err, true, ap);
         va_end(ap);
-
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
     }
 
     fflush(stderr);
@@ -848,12 +898,9 @@ void Log::outBasic(const char* str, ...)
     if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        WriteFormatted(logfile, NULL, str, false, ap);
         va_end(ap);
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -893,15 +940,10 @@ void Log::outDetail(const char* str, ...)
 
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        WriteFormatted(logfile, NULL, str, false, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -941,15 +983,10 @@ void Log::outDebug(const char* str, ...)
 
     if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        WriteFormatted(logfile, NULL, str, false, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -990,12 +1027,9 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        WriteFormatted(logfile, NULL, str, true, ap);
         va_end(ap);
-        fflush(logfile);
     }
 
     if (m_gmlog_per_account)
@@ -1014,12 +1048,9 @@ void Log::outCommand(uint32 account, const char* str, ...)
     else if (gmLogfile)
     {
         va_list ap;
-        outTimestamp(gmLogfile);
         va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
+        WriteFormatted(gmLogfile, NULL, str, true, ap);
         va_end(ap);
-        fflush(gmLogfile);
     }
 
     fflush(stdout);
@@ -1034,9 +1065,7 @@ void Log::outWarden()
     printf("\n");
     if (wardenLogfile)
     {
-        outTimestamp(wardenLogfile);
-        fprintf(wardenLogfile, "\n");
-        fflush(wardenLogfile);
+        WriteLine(wardenLogfile, "", 0, true, false);
     }
 
     fflush(stdout);
@@ -1077,16 +1106,9 @@ void Log::outWarden(const char* str, ...)
     if (wardenLogfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
         va_list ap;
-
-        outTimestamp(wardenLogfile);
-        fprintf(wardenLogfile, "[Warden]: ");
-
         va_start(ap, str);
-        vfprintf(wardenLogfile, str, ap);
-        fprintf(wardenLogfile, "\n");
+        WriteFormatted(wardenLogfile, "[Warden]: ", str, false, ap);
         va_end(ap);
-
-        fflush(wardenLogfile);
     }
 
     fflush(stdout);
@@ -1102,12 +1124,9 @@ void Log::outChar(const char* str, ...)
     if (charLogfile)
     {
         va_list ap;
-        outTimestamp(charLogfile);
         va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
+        WriteFormatted(charLogfile, NULL, str, true, ap);
         va_end(ap);
-        fflush(charLogfile);
     }
 }
 
@@ -1122,23 +1141,13 @@ void Log::outErrorScriptLib()
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-        {
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        }
-        else
-        {
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        }
-        fflush(logfile);
+        std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR:> " : "<Scripting Library ERROR>: ";
+        WriteLine(logfile, prefix.c_str(), prefix.size(), true, true);
     }
 
     if (scriptErrLogFile)
     {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
+        WriteLine(scriptErrLogFile, "", 0, true, true);
     }
 
     fflush(stderr);
@@ -1176,35 +1185,19 @@ void Log::outErrorScriptLib(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-        {
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        }
-        else
-        {
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        }
+        std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR>: " : "<Scripting Library ERROR>: ";
 
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteFormatted(logfile, prefix.c_str(), err, true, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (scriptErrLogFile)
     {
-        outTimestamp(scriptErrLogFile);
-
         va_list ap;
         va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
+        WriteFormatted(scriptErrLogFile, NULL, err, true, ap);
         va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
     }
 
     fflush(stderr);
@@ -1217,35 +1210,45 @@ void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeNam
         return;
     }
 
-    ACE_GUARD(ACE_Thread_Mutex, GuardObj, m_worldLogMtx);
-
-    outTimestamp(worldLogfile);
+    static char const hexDigits[] = "0123456789ABCDEF";
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %u\nLENGTH: %zu\nOPCODE: %s (0x%.4X)\nDATA:\n",
+    char header[256];
+    int headerLen = snprintf(header, sizeof(header), "\n%s:\nSOCKET: %u\nLENGTH: %zu\nOPCODE: %s (0x%.4X)\nDATA:\n",
         incoming ? "CLIENT" : "SERVER",
         socket, packet->size(), opcodeName, opcode);
 
+    // format the whole dump first, so it is written as one record
+    std::string text(header, std::min<size_t>(std::max(headerLen, 0), sizeof(header) - 1));
+    text.reserve(text.size() + packet->size() * 3 + packet->size() / 16 + 2);
+
     size_t p = 0;
     while (p < packet->size())
     {
         for (size_t j = 0; j < 16 && p < packet->size(); ++j)
         {
-            fprintf(worldLogfile, "%.2X ", (*packet)[p++]);
+            uint8 value = (*packet)[p++];
+            text += hexDigits[value >> 4];
+            text += hexDigits[value & 0x0F];
+            text += ' ';
         }
 
-        fprintf(worldLogfile, "\n");
+        text += '\n';
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    text += '\n';
+
+    ACE_GUARD(ACE_Thread_Mutex, GuardObj, m_worldLogMtx);
+    WriteLine(worldLogfile, text.c_str(), text.size(), true, false);
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
     if (charLogfile)
     {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
+        std::ostringstream text;
+        text << "== START DUMP == (account: " << account_id << " guid: " << guid << " name: " << name << " )\n" << str << "\n== END DUMP ==";
+        std::string dump = text.str();
+        WriteLine(charLogfile, dump.c_str(), dump.size(), false, true);
     }
 }
 
@@ -1259,12 +1262,9 @@ void Log::outRALog(const char* str, ...)
     if (raLogfile)
     {
         va_list ap;
-        outTimestamp(raLogfile);
         va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
+        WriteFormatted(raLogfile, NULL, str, true, ap);
         va_end(ap);
-        fflush(raLogfile);
     }
 
     fflush(stdout);
@@ -1297,14 +1297,23 @@ void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
     m_scriptLibName = libName;
 
-    if (scriptErrLogFile)
+    FILE* oldFile = scriptErrLogFile;
+    scriptErrLogFile = NULL;
+
+    if (oldFile)
     {
-        fclose(scriptErrLogFile);
+        if (m_writer)
+        {
+            m_writer->CloseFile(oldFile);                   // queued lines may refer to the file
+        }
+        else
+        {
+            fclose(oldFile);
+        }
     }
 
     if (!fname)
     {
-        scriptErrLogFile = NULL;
         return;
     }
 
@@ -28,8 +28,11 @@
 #include "Common/Common.h"
 #include "Policies/Singleton.h"
 
+#include <stdarg.h>
+
 class Config;
 class ByteBuffer;
+class LogWriter;
 
 /**
  * @brief Logging severity levels for message filtering
@@ -155,6 +158,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
      */
     ~Log()
     {
+        StopAsyncWriter();
+
         if (logfile != NULL)
         {
             fclose(logfile);
@@ -508,6 +513,40 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          */
         FILE* openGmlogPerAccount(uint32 account);
 
+        /**
+         * @brief Write one line to a log file, directly or through the writer thread
+         *
+         * @param file
+         * @param text
+         * @param length
+         * @param timestamp
+         * @param important
+         */
+        void WriteLine(FILE* file, char const* text, size_t length, bool timestamp, bool important);
+
+        /**
+         * @brief Format a message and write it as one line to a log file
+         *
+         * @param file
+         * @param prefix
+         * @param format
+         * @param important
+         * @param ap
+         */
+        void WriteFormatted(FILE* file, char const* prefix, char const* format, bool important, va_list ap);
+
+        /**
+         * @brief
+         *
+         */
+        void StartAsyncWriter();
+
+        /**
+         * @brief
+         *
+         */
+        void StopAsyncWriter();
+
         FILE* raLogfile; /**< TODO */
         FILE* logfile; /**< TODO */
         FILE* gmLogfile; /**< TODO */
@@ -542,6 +581,10 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         std::string m_gmlog_filename_format; /**< TODO */
 
         char const* m_scriptLibName; /**< TODO */
+
+        // asynchronous file output, NULL if disabled
+        LogWriter* m_writer; /**< writer thread body, owned by m_writerThread */
+        ACE_Based::Thread* m_writerThread; /**< thread writing the log files */
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
@@ -0,0 +1,436 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/**
+ * @file LogWriter.cpp
+ * @brief Asynchronous log file writer
+ *
+ * Log lines are appended by the logging threads to per thread ring
+ * buffers and written to the log files by a single background thread.
+ * See LogWriter for the record layout and the overflow policy.
+ */
+
+#include "LogWriter.h"
+#include "Utilities/Util.h"
+
+#define LOG_WRITER_MIN_RING     4096                        // bytes
+#define LOG_WRITER_SLEEP        10                          // ms between two passes
+
+/**
+ * @brief Round a record size up to the record alignment
+ * @param size Size in bytes
+ * @return Aligned size
+ */
+static inline uint32 AlignRecord(uint32 size)
+{
+    return (size + 7) & ~uint32(7);
+}
+
+/**
+ * @brief Constructor
+ * @param ringSize Size of the ring buffer of each thread in bytes, rounded up to a power of two
+ * @param dropOnOverflow True to drop unimportant records when a ring is full
+ * @param reportFile File that receives the dropped record reports, may be NULL
+ */
+LogWriter::LogWriter(uint32 ringSize, bool dropOnOverflow, FILE* reportFile) :
+    m_id(0), m_ringSize(LOG_WRITER_MIN_RING), m_dropOnOverflow(dropOnOverflow), m_reportFile(reportFile),
+    m_running(true), m_dropped(0), m_reportedDropped(0), m_cachedStamp(0)
+{
+    static std::atomic<uint32> nextId(0);
+    m_id = nextId.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    while (m_ringSize < ringSize && m_ringSize < 0x40000000)
+    {
+        m_ringSize <<= 1;
+    }
+
+    // a quarter of the ring at most, so a long line does not stall the thread until the ring is empty
+    m_maxText = m_ringSize / 4 - sizeof(RecordHeader);
+    m_cachedStampText[0] = '\0';
+}
+
+LogWriter::~LogWriter()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_ringsLock);
+
+    for (std::vector<Ring*>::const_iterator itr = m_rings.begin(); itr != m_rings.end(); ++itr)
+    {
+        if ((*itr)->orphaned.load(std::memory_order_acquire))
+        {
+            delete *itr;
+        }
+    }
+}
+
+/**
+ * @brief Marks the rings of an ending thread, their writers free them once written
+ */
+LogWriter::ThreadRings::~ThreadRings()
+{
+    for (std::vector<std::pair<uint32, Ring*> >::const_iterator itr = rings.begin(); itr != rings.end(); ++itr)
+    {
+        itr->second->orphaned.store(true, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Get the ring of the calling thread for this writer, create it at the first call
+ *
+ * A thread may log through several writers (log files and packet capture),
+ * it keeps one ring for each of them.
+ *
+ * @return Ring of the calling thread
+ */
+LogWriter::Ring* LogWriter::GetThreadRing()
+{
+    static thread_local ThreadRings threadRings;
+
+    for (std::vector<std::pair<uint32, Ring*> >::const_iterator itr = threadRings.rings.begin(); itr != threadRings.rings.end(); ++itr)
+    {
+        if (itr->first == m_id)
+        {
+            return itr->second;
+        }
+    }
+
+    Ring* ring = new Ring(m_ringSize);
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_ringsLock, NULL);
+        m_rings.push_back(ring);
+    }
+
+    threadRings.rings.push_back(std::make_pair(m_id, ring));
+    return ring;
+}
+
+/**
+ * @brief Queue a line for a log file
+ *
+ * Lines longer than a quarter of the ring are not queued but written at
+ * once by WriteDirect, after the lines queued before them.
+ *
+ * @param file Target file
+ * @param text Line text without line end, need not be null terminated
+ * @param length Text length
+ * @param timestamp True to prefix the line with the time of the call
+ * @param important True if the line must not be dropped
+ * @return False if the writer is stopped, the caller must write the line itself
+ */
+bool LogWriter::Write(FILE* file, char const* text, size_t length, bool timestamp, bool important)
+{
+    if (length > m_maxText && m_running.load(std::memory_order_relaxed))
+    {
+        WriteDirect(file, text, length, timestamp);
+        return true;
+    }
+
+    return Queue(file, NULL, 0, text, length, timestamp ? int64(time(NULL)) : 0, important ? RECORD_IMPORTANT : 0);
+}
+
+/**
+ * @brief Write a line at once, after all lines queued so far
+ * @param file Target file
+ * @param text Line text without line end, need not be null terminated
+ * @param length Text length
+ * @param timestamp True to prefix the line with the time of the call
+ */
+void LogWriter::WriteDirect(FILE* file, char const* text, size_t length, bool timestamp)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_drainLock);
+
+    // the lines queued before this one go first
+    Drain();
+
+    RecordHeader header = { file, timestamp ? int64(time(NULL)) : 0, uint32(length), RECORD_IMPORTANT };
+    WriteRecord(header, text);
+    fflush(file);
+    m_dirtyFiles.clear();
+}
+
+/**
+ * @brief Queue binary data for a file, written as is
+ * @param file Target file
+ * @param head First part
+ * @param headLength Length of the first part
+ * @param data Second part
+ * @param dataLength Length of the second part
+ * @return False if the data was not queued, dropped data counts as queued
+ */
+bool LogWriter::WriteRaw(FILE* file, void const* head, size_t headLength, void const* data, size_t dataLength)
+{
+    // too long for the ring, counted like the data dropped when the ring is full
+    if (headLength + dataLength > m_maxText)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return Queue(file, static_cast<char const*>(head), headLength, static_cast<char const*>(data), dataLength, 0, RECORD_RAW);
+}
+
+/**
+ * @brief Copy a record into the ring of the calling thread
+ * @param file Target file
+ * @param prefix Optional first part of the text
+ * @param prefixLength Length of the first part
+ * @param text Text
+ * @param length Text length
+ * @param stamp Time of the call, 0 for none
+ * @param flags RecordFlags
+ * @return False if the record was not queued
+ */
+bool LogWriter::Queue(FILE* file, char const* prefix, size_t prefixLength, char const* text, size_t length, int64 stamp, uint32 flags)
+{
+    if (!m_running.load(std::memory_order_relaxed) || prefixLength + length > m_maxText)
+    {
+        return false;
+    }
+
+    Ring* ring = GetThreadRing();
+    if (!ring)
+    {
+        return false;
+    }
+
+    uint32 const mask = m_ringSize - 1;
+    uint32 const total = uint32(prefixLength + length);
+    uint32 const needed = AlignRecord(sizeof(RecordHeader) + total);
+
+    uint32 head, padding;
+    for (;;)
+    {
+        head = ring->head.load(std::memory_order_relaxed);
+        uint32 tail = ring->tail.load(std::memory_order_acquire);
+
+        // a record never wraps, the rest of the ring is skipped instead
+        uint32 contiguous = m_ringSize - (head & mask);
+        padding = contiguous < needed ? contiguous : 0;
+
+        if (m_ringSize - (head - tail) >= padding + needed)
+        {
+            break;
+        }
+
+        if (!(flags & RECORD_IMPORTANT) && m_dropOnOverflow)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (!m_running.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        ACE_Based::Thread::Sleep(1);
+    }
+
+    if (padding)
+    {
+        if (padding >= sizeof(RecordHeader))
+        {
+            RecordHeader pad = { NULL, 0, 0, 0 };
+            memcpy(&ring->buffer[head & mask], &pad, sizeof(pad));
+        }
+        head += padding;
+    }
+
+    RecordHeader header = { file, stamp, total, flags };
+    char* dest = &ring->buffer[head & mask];
+    memcpy(dest, &header, sizeof(header));
+    if (prefixLength)
+    {
+        memcpy(dest + sizeof(header), prefix, prefixLength);
+    }
+    if (length)
+    {
+        memcpy(dest + sizeof(header) + prefixLength, text, length);
+    }
+
+    ring->head.store(head + needed, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Write all queued lines of all threads and flush the files
+ */
+void LogWriter::Flush()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_drainLock);
+    Drain();
+}
+
+/**
+ * @brief Write the queued lines and close a file
+ * @param file File to close
+ */
+void LogWriter::CloseFile(FILE* file)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_drainLock);
+
+    Drain();
+    fclose(file);
+}
+
+/**
+ * @brief Stop event, queued lines are written before the thread ends
+ *
+ * Lines queued by other threads while the writer stops may be lost.
+ */
+void LogWriter::Stop()
+{
+    m_running.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Main thread loop
+ */
+void LogWriter::run()
+{
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        ACE_Based::Thread::Sleep(LOG_WRITER_SLEEP);
+        Flush();
+    }
+
+    Flush();
+}
+
+/**
+ * @brief Write the queued lines of all rings, caller must hold m_drainLock
+ * @return True if anything was written
+ */
+bool LogWriter::Drain()
+{
+    std::vector<Ring*> rings;
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_ringsLock, false);
+        rings = m_rings;
+    }
+
+    uint32 const mask = m_ringSize - 1;
+    bool written = false;
+    std::vector<Ring*> finished;
+
+    for (std::vector<Ring*>::const_iterator itr = rings.begin(); itr != rings.end(); ++itr)
+    {
+        Ring* ring = *itr;
+
+        // checked before reading, lines of an ended thread are all visible then
+        bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+
+        uint32 tail = ring->tail.load(std::memory_order_relaxed);
+        uint32 head = ring->head.load(std::memory_order_acquire);
+        while (tail != head)
+        {
+            uint32 offset = tail & mask;
+            uint32 contiguous = m_ringSize - offset;
+            if (contiguous < sizeof(RecordHeader))
+            {
+                tail += contiguous;
+                continue;
+            }
+
+            RecordHeader header;
+            memcpy(&header, &ring->buffer[offset], sizeof(header));
+            if (!header.file)
+            {
+                tail += contiguous;
+                continue;
+            }
+
+            WriteRecord(header, &ring->buffer[offset + sizeof(header)]);
+            tail += AlignRecord(sizeof(RecordHeader) + header.length);
+            written = true;
+        }
+
+        ring->tail.store(tail, std::memory_order_release);
+
+        if (orphaned)
+        {
+            finished.push_back(ring);
+        }
+    }
+
+    if (!finished.empty())
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_ringsLock, written);
+        for (std::vector<Ring*>::const_iterator itr = finished.begin(); itr != finished.end(); ++itr)
+        {
+            m_rings.erase(std::remove(m_rings.begin(), m_rings.end(), *itr), m_rings.end());
+            delete *itr;
+        }
+    }
+
+    uint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped && m_reportFile)
+    {
+        char text[96];
+        int len = snprintf(text, sizeof(text), "Log buffer full, " UI64FMTD " lines dropped", dropped - m_reportedDropped);
+        RecordHeader header = { m_reportFile, int64(time(NULL)), uint32(std::max(len, 0)), RECORD_IMPORTANT };
+        WriteRecord(header, text);
+        m_reportedDropped = dropped;
+    }
+
+    for (std::vector<FILE*>::const_iterator itr = m_dirtyFiles.begin(); itr != m_dirtyFiles.end(); ++itr)
+    {
+        fflush(*itr);
+    }
+    m_dirtyFiles.clear();
+
+    return written;
+}
+
+/**
+ * @brief Write one record to its file, without flushing
+ * @param header Record header
+ * @param text Record text
+ */
+void LogWriter::WriteRecord(RecordHeader const& header, char const* text)
+{
+    if (header.stamp)
+    {
+        // many lines share the same second, expand it once
+        if (header.stamp != m_cachedStamp)
+        {
+            std::tm aTm = safe_localtime(time_t(header.stamp));
+            snprintf(m_cachedStampText, sizeof(m_cachedStampText), "%-4d-%02d-%02d %02d:%02d:%02d ",
+                     aTm.tm_year + 1900, aTm.tm_mon + 1, aTm.tm_mday, aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+            m_cachedStamp = header.stamp;
+        }
+
+        fputs(m_cachedStampText, header.file);
+    }
+
+    fwrite(text, 1, header.length, header.file);
+    if (!(header.flags & RECORD_RAW))
+    {
+        fputc('\n', header.file);
+    }
+
+    if (std::find(m_dirtyFiles.begin(), m_dirtyFiles.end(), header.file) == m_dirtyFiles.end())
+    {
+        m_dirtyFiles.push_back(header.file);
+    }
+}
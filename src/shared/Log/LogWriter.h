@@ -0,0 +1,198 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOSSERVER_LOGWRITER_H
+#define MANGOSSERVER_LOGWRITER_H
+
+#include "Common/Common.h"
+
+#include <vector>
+
+/**
+ * @brief Background writer for log files
+ *
+ * Every thread that logs gets its own single producer / single consumer
+ * ring buffer, so logging threads never wait for each other or for disk
+ * I/O. A record holds the target file, the time of the call and the
+ * already formatted text; the timestamp is expanded and the text written
+ * by one writer thread, which flushes each touched file once per pass
+ * instead of once per line.
+ *
+ * When a ring is full, important records (errors, GM and character logs)
+ * wait for the writer, all other records wait or are dropped depending on
+ * the configured overflow policy. Dropped records are counted and reported
+ * in the main log file.
+ */
+class LogWriter : public ACE_Based::Runnable
+{
+    public:
+        /**
+         * @brief Constructor
+         * @param ringSize Size of the ring buffer of each thread in bytes
+         * @param dropOnOverflow True to drop unimportant records when a ring is full
+         * @param reportFile File that receives the dropped record reports, may be NULL
+         */
+        LogWriter(uint32 ringSize, bool dropOnOverflow, FILE* reportFile);
+
+        /**
+         * @brief Destructor
+         *
+         * Rings of threads which are still running are left allocated, they
+         * may still be referenced by those threads.
+         */
+        ~LogWriter();
+
+        /**
+         * @brief Queue a line for a log file
+         * @param file Target file
+         * @param text Line text without line end, need not be null terminated
+         * @param length Text length
+         * @param timestamp True to prefix the line with the time of the call
+         * @param important True if the line must not be dropped
+         * @return False if the writer is stopped, the caller must write the line itself
+         */
+        bool Write(FILE* file, char const* text, size_t length, bool timestamp, bool important);
+
+        /**
+         * @brief Write a line at once, after all lines queued so far
+         *
+         * Used for lines too long for the ring. The line is written by the
+         * calling thread, the writer thread does not write meanwhile.
+         *
+         * @param file Target file
+         * @param text Line text without line end, need not be null terminated
+         * @param length Text length
+         * @param timestamp True to prefix the line with the time of the call
+         */
+        void WriteDirect(FILE* file, char const* text, size_t length, bool timestamp);
+
+        /**
+         * @brief Queue binary data for a file, written as is
+         *
+         * The data is given in two parts, so a record header and a payload
+         * need not be copied together first. Raw data is never important,
+         * data longer than a quarter of the ring is dropped and counted.
+         *
+         * @param file Target file
+         * @param head First part
+         * @param headLength Length of the first part
+         * @param data Second part
+         * @param dataLength Length of the second part
+         * @return False if the data was not queued, dropped data counts as queued
+         */
+        bool WriteRaw(FILE* file, void const* head, size_t headLength, void const* data, size_t dataLength);
+
+        /**
+         * @brief Write all queued lines of all threads and flush the files
+         *
+         * Files still referenced by queued lines are closed with CloseFile.
+         */
+        void Flush();
+
+        /**
+         * @brief Write the queued lines and close a file
+         *
+         * The writer thread does not touch the file once this returns. The
+         * caller must make sure no more lines are logged to the file.
+         *
+         * @param file File to close
+         */
+        void CloseFile(FILE* file);
+
+        /**
+         * @brief Stop event, queued lines are written before the thread ends
+         */
+        void Stop();
+
+        /**
+         * @brief Main thread loop
+         */
+        virtual void run();
+
+        /**
+         * @brief Get number of dropped lines since start
+         * @return Dropped line count
+         */
+        uint64 GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        enum RecordFlags
+        {
+            RECORD_IMPORTANT    = 0x01,                     // never dropped
+            RECORD_RAW          = 0x02                      // binary data, no line end
+        };
+
+        struct RecordHeader
+        {
+            FILE* file;                                     // NULL for padding up to the ring end
+            int64 stamp;                                    // time of the call, 0 for none
+            uint32 length;                                  // text length
+            uint32 flags;                                   // RecordFlags
+        };
+
+        struct Ring
+        {
+            explicit Ring(uint32 size) : buffer(size), head(0), tail(0), orphaned(false) {}
+
+            std::vector<char> buffer;
+            std::atomic<uint32> head;                       // written by the owning thread only
+            std::atomic<uint32> tail;                       // written by the writer only
+            std::atomic<bool> orphaned;                     // owning thread has ended
+        };
+
+        /**
+         * @brief Owns the rings of a thread, one per writer, marks them orphaned when the thread ends
+         */
+        struct ThreadRings
+        {
+            ~ThreadRings();
+
+            std::vector<std::pair<uint32, Ring*> > rings;   // by writer id
+        };
+
+        Ring* GetThreadRing();
+        bool Queue(FILE* file, char const* prefix, size_t prefixLength, char const* text, size_t length, int64 stamp, uint32 flags);
+        bool Drain();
+        void WriteRecord(RecordHeader const& header, char const* text);
+
+        uint32 m_id;                                        // unique, a new writer may reuse the address of a deleted one
+        uint32 m_ringSize;
+        uint32 m_maxText;                                   // longer lines are written directly
+        bool m_dropOnOverflow;
+        FILE* m_reportFile;
+        std::atomic<bool> m_running;
+        std::atomic<uint64> m_dropped;
+        uint64 m_reportedDropped;
+
+        ACE_Thread_Mutex m_ringsLock;                       // guards m_rings
+        std::vector<Ring*> m_rings;
+
+        ACE_Thread_Mutex m_drainLock;                       // single consumer of all rings
+        std::vector<FILE*> m_dirtyFiles;                    // written since the last flush
+
+        int64 m_cachedStamp;                                // last expanded timestamp
+        char m_cachedStampText[80];
+};
+
+#endif
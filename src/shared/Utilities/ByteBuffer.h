@@ -685,6 +685,13 @@ class ByteBuffer
          */
         size_t size() const { return _storage.size(); }
 
+        /**
+         * @brief Get the number of bytes the buffer holds without reallocating
+         *
+         * @return size_t
+         */
+        size_t capacity() const { return _storage.capacity(); }
+
         /**
          * @brief
          *
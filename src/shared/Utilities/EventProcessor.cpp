@@ -31,6 +31,8 @@
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_eventsHead = nullptr;
+    m_eventsTail = nullptr;
     m_aborting = false;
 }
 
@@ -54,12 +56,11 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    BasicEvent* Event;
+    while ((Event = m_eventsHead) != nullptr && Event->m_execTime <= m_time)
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        // remove event from queue
+        RemoveFromQueue(Event);
 
         if (!Event->to_Abort)
         {
@@ -88,34 +89,37 @@ void EventProcessor::KillAllEvents(bool force)
     m_aborting = true;
 
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    for (BasicEvent* i = m_eventsHead; i != nullptr;)
     {
-        EventList::iterator i_old = i;
-        ++i;
+        BasicEvent* i_old = i;
+        i = i->m_nextEvent;
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        i_old->to_Abort = true;
+        i_old->Abort(m_time);
+        if (force || i_old->IsDeletable())
         {
-            delete i_old->second;
-
             if (!force)                                     // need per-element cleanup
             {
-                m_events.erase(i_old);
+                RemoveFromQueue(i_old);
             }
+
+            delete i_old;
         }
     }
 
     // fast clear event list (in force case)
     if (force)
     {
-        m_events.clear();
+        m_eventsHead = nullptr;
+        m_eventsTail = nullptr;
     }
 }
 
 /**
  * @brief Adds an event to the event processor.
  *
+ * Events with equal execution time keep the order they were added in.
+ *
  * @param Event Pointer to the event to add.
  * @param e_time Execution time of the event.
  * @param set_addtime If true, sets the add time of the event.
@@ -128,7 +132,65 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     }
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+
+    // find the last event that executes not later, searching from the tail
+    BasicEvent* prev = m_eventsTail;
+    while (prev && prev->m_execTime > e_time)
+    {
+        prev = prev->m_prevEvent;
+    }
+
+    BasicEvent* next = prev ? prev->m_nextEvent : m_eventsHead;
+
+    Event->m_prevEvent = prev;
+    Event->m_nextEvent = next;
+
+    if (prev)
+    {
+        prev->m_nextEvent = Event;
+    }
+    else
+    {
+        m_eventsHead = Event;
+    }
+
+    if (next)
+    {
+        next->m_prevEvent = Event;
+    }
+    else
+    {
+        m_eventsTail = Event;
+    }
+}
+
+/**
+ * @brief Unlinks an event from the queue.
+ *
+ * @param Event Pointer to a queued event.
+ */
+void EventProcessor::RemoveFromQueue(BasicEvent* Event)
+{
+    if (Event->m_prevEvent)
+    {
+        Event->m_prevEvent->m_nextEvent = Event->m_nextEvent;
+    }
+    else
+    {
+        m_eventsHead = Event->m_nextEvent;
+    }
+
+    if (Event->m_nextEvent)
+    {
+        Event->m_nextEvent->m_prevEvent = Event->m_prevEvent;
+    }
+    else
+    {
+        m_eventsTail = Event->m_prevEvent;
+    }
+
+    Event->m_prevEvent = nullptr;
+    Event->m_nextEvent = nullptr;
 }
 
 /**
@@ -26,7 +26,6 @@
 #define MANGOS_H_EVENTPROCESSOR
 
 #include "Platform/Define.h"
-#include <map>
 
 /**
  * @brief Note. All times are in milliseconds here.
@@ -40,7 +39,7 @@ class BasicEvent
          * Initializes member variables to_Abort, m_addTime, and m_execTime.
          */
         BasicEvent()
-            : to_Abort(false), m_addTime(0), m_execTime(0) // Initialize member variables
+            : to_Abort(false), m_addTime(0), m_execTime(0), m_prevEvent(nullptr), m_nextEvent(nullptr) // Initialize member variables
         {
         }
 
@@ -79,17 +78,23 @@ class BasicEvent
         // These can be used for time offset control
         uint64 m_addTime; /**< Time when the event was added to queue, filled by event handler */
         uint64 m_execTime; /**< Planned time of next execution, filled by event handler */
-};
 
-/**
- * @brief Typedef for a multimap of events
- *
- */
-typedef std::multimap<uint64, BasicEvent*> EventList;
+    private:
+        friend class EventProcessor;
+
+        // Intrusive links of the owning EventProcessor queue, so queueing an event does not allocate
+        BasicEvent* m_prevEvent; /**< Previous event in execution order */
+        BasicEvent* m_nextEvent; /**< Next event in execution order */
+};
 
 /**
  * @brief Event Processor class
  *
+ * Keeps the pending events in an intrusive doubly linked list ordered by
+ * execution time. A unit rarely has more than a handful of pending events
+ * and new events are mostly scheduled after the existing ones, so insertion
+ * searches from the tail and usually appends in constant time, taking the
+ * next due event and unlinking one are constant time as well.
  */
 class EventProcessor
 {
@@ -138,8 +143,16 @@ class EventProcessor
         uint64 CalculateTime(uint64 t_offset) const;
 
     protected:
+        /**
+         * @brief Unlinks an event from the queue
+         *
+         * @param Event Pointer to a queued event
+         */
+        void RemoveFromQueue(BasicEvent* Event);
+
         uint64 m_time; /**< Current time in milliseconds */
-        EventList m_events; /**< List of events */
+        BasicEvent* m_eventsHead; /**< First event to execute */
+        BasicEvent* m_eventsTail; /**< Last event to execute */
         bool m_aborting; /**< Flag indicating if the event processor is aborting */
 };
 
@@ -0,0 +1,111 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "LatencyHistogram.h"
+
+/**
+ * @brief Construct an empty histogram
+ */
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+/**
+ * @brief Record one measured call
+ * @param micros Duration in microseconds
+ */
+void LatencyHistogram::Record(uint64 micros)
+{
+    uint32 bucket = 0;
+    while (bucket < LATENCY_HISTOGRAM_BUCKETS - 1 && (uint64(1) << bucket) <= micros)
+    {
+        ++bucket;
+    }
+
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(micros, std::memory_order_relaxed);
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    uint64 oldMax = m_max.load(std::memory_order_relaxed);
+    while (micros > oldMax && !m_max.compare_exchange_weak(oldMax, micros, std::memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * @brief Clear all collected data
+ */
+void LatencyHistogram::Reset()
+{
+    m_count.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+    for (uint32 i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+    {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Get average duration
+ * @return Average duration in microseconds
+ */
+uint64 LatencyHistogram::GetAverage() const
+{
+    uint64 count = GetCount();
+    return count ? m_total.load(std::memory_order_relaxed) / count : 0;
+}
+
+/**
+ * @brief Get latency percentile
+ * @param percentile Percentile in range 0..100
+ * @return Upper bound of the matching bucket in microseconds
+ */
+uint64 LatencyHistogram::GetPercentile(float percentile) const
+{
+    uint64 total = 0;
+    for (uint32 i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+    {
+        total += m_buckets[i].load(std::memory_order_relaxed);
+    }
+
+    if (!total)
+    {
+        return 0;
+    }
+
+    uint64 wanted = uint64(total * percentile / 100.0f);
+    uint64 seen = 0;
+    for (uint32 i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+    {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= wanted && seen)
+        {
+            return uint64(1) << i;
+        }
+    }
+
+    return GetMax();
+}
@@ -0,0 +1,105 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_LATENCYHISTOGRAM
+#define MANGOS_H_LATENCYHISTOGRAM
+
+#include "Platform/Define.h"
+
+#include <array>
+#include <atomic>
+
+#define LATENCY_HISTOGRAM_BUCKETS 32                        // log2 buckets of microseconds
+
+/**
+ * @brief Lock free latency statistics of one measured operation
+ *
+ * Keeps the call count, total and maximum duration and a log2 histogram of
+ * durations in microseconds. Any number of threads may record at once, all
+ * counters are relaxed atomics, so a report taken while recording may be off
+ * by the calls in flight.
+ */
+class LatencyHistogram
+{
+    public:
+        LatencyHistogram();
+
+        /**
+         * @brief Record one measured call
+         * @param micros Duration in microseconds
+         */
+        void Record(uint64 micros);
+
+        /**
+         * @brief Clear all collected data
+         */
+        void Reset();
+
+        /**
+         * @brief Get number of recorded calls
+         * @return Call count since last reset
+         */
+        uint64 GetCount() const { return m_count.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get average duration
+         * @return Average duration in microseconds
+         */
+        uint64 GetAverage() const;
+
+        /**
+         * @brief Get maximum duration
+         * @return Maximum duration in microseconds
+         */
+        uint64 GetMax() const { return m_max.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get latency percentile
+         *
+         * Resolution is limited by the log2 buckets, the upper bound of the
+         * bucket holding the percentile is returned.
+         *
+         * @param percentile Percentile in range 0..100
+         * @return Duration in microseconds
+         */
+        uint64 GetPercentile(float percentile) const;
+
+        /**
+         * @brief Get calls per second
+         * @param elapsed Milliseconds the calls were recorded over
+         * @return Rate of calls
+         */
+        float GetRate(uint32 elapsed) const { return elapsed ? GetCount() * 1000.0f / elapsed : 0.0f; }
+
+    private:
+        LatencyHistogram(LatencyHistogram const&);
+        LatencyHistogram& operator=(LatencyHistogram const&);
+
+        std::atomic<uint64> m_count;
+        std::atomic<uint64> m_total;
+        std::atomic<uint64> m_max;
+        std::array<std::atomic<uint64>, LATENCY_HISTOGRAM_BUCKETS> m_buckets;
+};
+
+#endif